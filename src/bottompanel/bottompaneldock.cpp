@@ -2,6 +2,8 @@
 
 #include <QTabWidget>
 
+#include "projectsearchwidget.h"
+#include "historysearchwidget.h"
 #include "mainwindow.h"
 
 BottomPanelDock::BottomPanelDock(QWidget *pParent): QDockWidget (pParent)
@@ -25,6 +27,38 @@ BottomPanelDock::BottomPanelDock(QWidget *pParent): QDockWidget (pParent)
     QWidget *pVersionsCtrl = new QWidget;
     mpTabWgt->addTab(pVersionsCtrl, tr("Version Control"));
 
+    // search in project files
+    mpProjectSearchWgt = new ProjectSearchWidget;
+    mpTabWgt->addTab(mpProjectSearchWgt, tr("Search Results"));
+
+    // search in comments of project files
+    mpCommentsSearchWgt = new HistorySearchWidget(HistorySearchWidget::CommentsScope);
+    mpTabWgt->addTab(mpCommentsSearchWgt, tr("Comments"));
+
     setWidget(mpTabWgt);
     setMaximumHeight(pParent->width() / 5);
 }
+
+ProjectSearchWidget *BottomPanelDock::getProjectSearchWidget() const
+{
+    return mpProjectSearchWgt;
+}
+
+HistorySearchWidget *BottomPanelDock::getCommentsSearchWidget() const
+{
+    return mpCommentsSearchWgt;
+}
+
+void BottomPanelDock::showProjectSearchTab()
+{
+    show();
+    mpTabWgt->setCurrentWidget(mpProjectSearchWgt);
+    mpProjectSearchWgt->focusSearchLine();
+}
+
+void BottomPanelDock::showCommentsSearchTab()
+{
+    show();
+    mpTabWgt->setCurrentWidget(mpCommentsSearchWgt);
+    mpCommentsSearchWgt->focusSearchLine();
+}
@@ -7,13 +7,23 @@ QT_BEGIN_NAMESPACE
 class QTabWidget;
 QT_END_NAMESPACE
 
+class ProjectSearchWidget;
+class HistorySearchWidget;
+
 class BottomPanelDock: public QDockWidget
 {
     Q_OBJECT
 
     QTabWidget *mpTabWgt;
+    ProjectSearchWidget *mpProjectSearchWgt;
+    HistorySearchWidget *mpCommentsSearchWgt;
 public:
     explicit BottomPanelDock(QWidget *pParent = nullptr);
+
+    ProjectSearchWidget *getProjectSearchWidget() const;
+    HistorySearchWidget *getCommentsSearchWidget() const;
+    void showProjectSearchTab();
+    void showCommentsSearchTab();
 };
 
 #endif // BOTTOMPANELDOCK_H
@@ -28,25 +28,48 @@ Item
         highlightFollowsCurrentItem: true
         boundsBehavior:              Flickable.StopAtBounds
 
-        onCountChanged:
-        {
-            Qt.callLater( listView.positionViewAtEnd )
-        }
         onHeightChanged:
         {
             listView.positionViewAtEnd()
         }
+        // older history is loaded when the oldest loaded message is reached
+        onAtYBeginningChanged:
+        {
+            if (atYBeginning)
+            {
+                messagesSource.fetchOlderMessages()
+            }
+        }
 
         model: messagesModel
 
         ScrollBar.vertical: ScrollBar {}
     }
+    Connections
+    {
+        target: messagesSource
+
+        // view follows new messages, history loaded above keeps view in place
+        onRowsInserted:
+        {
+            if (last === messagesSource.rowCount() - 1)
+            {
+                Qt.callLater( listView.positionViewAtEnd )
+            }
+        }
+        onModelReset:
+        {
+            Qt.callLater( listView.positionViewAtEnd )
+        }
+    }
     DelegateModel
     {
         id: messagesModel
 
         model: MessagesModel
         {
+            id: messagesSource
+
             list: messagesList
         }
 
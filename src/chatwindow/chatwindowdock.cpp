@@ -1,6 +1,9 @@
 #include "chatwindowdock.h"
 #include "qmlchatwidget.h"
 #include "chatwidget.h"
+#include "historysearchwidget.h"
+
+#include <QBoxLayout>
 // ==========================================================================================
 // ==========================================================================================
 //                                                                                CONSTRUCTOR
@@ -9,7 +12,16 @@ ChatWindowDock::ChatWindowDock(QWidget *pParent) :
 {
     // Build chat widget & connect it to the dock
     mpChatWidget = new QmlChatWidget;
-    setWidget(mpChatWidget);
+
+    // search in chat history is placed above the chat
+    QWidget *pContainer = new QWidget;
+    QVBoxLayout *pLayout = new QVBoxLayout;
+    pLayout->setContentsMargins(0, 0, 0, 0);
+    mpHistorySearchWidget = new HistorySearchWidget(HistorySearchWidget::MessagesScope);
+    pLayout->addWidget(mpHistorySearchWidget);
+    pLayout->addWidget(mpChatWidget, 1);
+    pContainer->setLayout(pLayout);
+    setWidget(pContainer);
 
     connect(mpChatWidget, &ChatWidgetInterface::startSharingRequested,
             this,         &ChatWindowDock::sendRequestOnStartSharing,
@@ -36,6 +48,16 @@ void ChatWindowDock::setUserName(const QString &userName)
 // ==========================================================================================
 // ==========================================================================================
 // ==========================================================================================
+//                                                         SHOW CHAT & FOCUS HISTORY SEARCH
+void ChatWindowDock::showHistorySearch()
+{
+    show();
+    raise();
+    mpHistorySearchWidget->focusSearchLine();
+}
+// ==========================================================================================
+// ==========================================================================================
+// ==========================================================================================
 //                                                       GIVE RECEIVED MESSAGE TO CHAT WIDGET
 void ChatWindowDock::pushMessageToChat(const QString userName, const QString message)
 {
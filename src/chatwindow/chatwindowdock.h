@@ -5,6 +5,8 @@
 #include <QDockWidget>
 #include "chatwidgetinterface.h"
 
+class HistorySearchWidget;
+
 // ==========================================================================================
 //                                                                          CHAT DOCKER PROXY
 // ==========================================================================================
@@ -19,6 +21,9 @@ public:
     // Current user name setter
     void setUserName(const QString &userName);
 
+    // Show chat & focus search in its history
+    void showHistorySearch();
+
 signals:
 
     // Signals to GUI that user starts or stops sharing
@@ -51,6 +56,7 @@ private:
 
     // Chat instance & chat title
     ChatWidgetInterface *mpChatWidget;
+    HistorySearchWidget *mpHistorySearchWidget;
     static const QString mscChatTitle;
 
     // Set custom behavior to keyPressEvent
@@ -4,30 +4,87 @@
 //                                                        CONSTRUCTOR: INTIALIZES AUTHOR NAME
 ChatMessagesController::ChatMessagesController(const QString &authorName,
                                                QObject *parent) :
-    QObject(parent), mcAuthorName(authorName), mDatabaseMessages()
+    QObject(parent), mcAuthorName(authorName), mDatabaseMessages(),
+    mOldestHistoryId(0), mHistoryExhausted(false)
 {
-    QDateTime fromDateTime = QDateTime::currentDateTimeUtc().addDays(-2);
-    QVector<Message> databaseMessages =
-            mDatabaseMessages.getMessageFromDb(fromDateTime.toString("yyyy-MM-dd HH:mm:ss"));
+    // Only the newest page is loaded, so chat is shown at once
+    mChatMessages = loadHistoryPage();
+}
+// ==========================================================================================
+// ==========================================================================================
+// ==========================================================================================
+//                                                                        HISTORY PAGE LOADER
+QVector<ChatMessage> ChatMessagesController::loadHistoryPage()
+{
+    // pages without messages which can be shown are skipped,
+    // so paging doesn't stop on them before history is exhausted
+    QVector<ChatMessage> historyMessages;
+    do
+    {
+        QVector<Message> databaseMessages =
+                mDatabaseMessages.getMessagesPageFromDb(mOldestHistoryTime,
+                                                        mOldestHistoryId,
+                                                        CHAT_HISTORY_PAGE_SIZE);
+        if (databaseMessages.size() < CHAT_HISTORY_PAGE_SIZE)
+        {
+            mHistoryExhausted = true;
+        }
+        if (!databaseMessages.isEmpty())
+        {
+            mOldestHistoryTime = databaseMessages.front().mTime;
+            mOldestHistoryId   = databaseMessages.front().mId;
+        }
 
-    std::for_each(databaseMessages.cbegin(),
-                  databaseMessages.cend(),
-                  [this](const Message & previouslySavedMessage)
-                  {
-                      if (previouslySavedMessage.mBody != QString() &&
-                          previouslySavedMessage.mUser != QString())
+        std::for_each(databaseMessages.cbegin(),
+                      databaseMessages.cend(),
+                      [&historyMessages](const Message & previouslySavedMessage)
                       {
-                          ChatMessage newChatMessage;
-                          newChatMessage.mAuthorName          = previouslySavedMessage.mUser;
-                          newChatMessage.mContent             = previouslySavedMessage.mBody;
-                          newChatMessage.mPublicationDateTime =
-                                  QDateTime::fromString(previouslySavedMessage.mTime,
-                                                        "yyyy-MM-dd HH:mm:ss");
-                          newChatMessage.mType                = ChatMessage::Type::UserMessage;
+                          if (previouslySavedMessage.mBody != QString() &&
+                              previouslySavedMessage.mUser != QString())
+                          {
+                              ChatMessage newChatMessage;
+                              newChatMessage.mAuthorName          = previouslySavedMessage.mUser;
+                              newChatMessage.mContent             = previouslySavedMessage.mBody;
+                              newChatMessage.mPublicationDateTime =
+                                      QDateTime::fromString(previouslySavedMessage.mTime,
+                                                            "yyyy-MM-dd HH:mm:ss");
+                              newChatMessage.mType                = ChatMessage::Type::UserMessage;
+
+                              historyMessages.append(newChatMessage);
+                          }
+                      });
+    }
+    while (historyMessages.isEmpty() && !mHistoryExhausted);
+    return historyMessages;
+}
+// ==========================================================================================
+// ==========================================================================================
+// ==========================================================================================
+//                                                              HISTORY AVAILABILITY CHECKER
+bool ChatMessagesController::canFetchMoreHistory() const
+{
+    return !mHistoryExhausted;
+}
+// ==========================================================================================
+// ==========================================================================================
+// ==========================================================================================
+//                                                          PREPEND OLDER HISTORY TO THE CHAT
+void ChatMessagesController::fetchMoreHistory()
+{
+    if (mHistoryExhausted)
+    {
+        return;
+    }
+
+    QVector<ChatMessage> historyMessages = loadHistoryPage();
+    if (historyMessages.isEmpty())
+    {
+        return;
+    }
 
-                          this->mChatMessages.append(newChatMessage);
-                      }
-                  });
+    emit preMessagesPrepended(historyMessages.size());
+    mChatMessages = historyMessages + mChatMessages;
+    emit postMessagesPrepended();
 }
 // ==========================================================================================
 // ==========================================================================================
@@ -70,7 +127,8 @@ void ChatMessagesController::appendMessage(const ChatMessage &newMessage)
                 newMessage.mPublicationDateTime.toString("yyyy-MM-dd HH:mm:ss");
         Message newDBMessage(newMessage.mContent, newMessage.mAuthorName, publicationTime);
 
-        mDatabaseMessages.addMessageToDb(newDBMessage);
+        // message is written in background, so chat isn't stalled by database
+        mDatabaseMessages.addMessageToDbAsync(newDBMessage);
     }
 }
 // ==========================================================================================
@@ -5,6 +5,9 @@
 #include "messagedb.h"
 #include "chatmessage.h"
 
+// Number of history messages loaded at once
+const int CHAT_HISTORY_PAGE_SIZE = 50;
+
 // ==========================================================================================
 //                                                                        MESSAGES CONTROLLER
 // ==========================================================================================
@@ -23,6 +26,10 @@ public:
     // Service messages generators
     void sendSystemMessage(SystemMessage messageType);
 
+    // Older history is loaded by pages when user scrolls to it
+    bool canFetchMoreHistory() const;
+    void fetchMoreHistory();
+
 signals:
 
     // Signal that user try to send message
@@ -31,6 +38,8 @@ signals:
     // Signals to messages list model that inform about changes
     void preMessageAppended();
     void postMessageAppended();
+    void preMessagesPrepended(int);
+    void postMessagesPrepended();
 
 public slots:
 
@@ -46,6 +55,14 @@ private:
     QVector<ChatMessage> mChatMessages;
 
     MessageDb            mDatabaseMessages;
+
+    // The oldest loaded history message, the next page is older than it
+    QString              mOldestHistoryTime;
+    int                  mOldestHistoryId;
+    bool                 mHistoryExhausted;
+
+    // Loads the next page of history, returns its messages which can be displayed
+    QVector<ChatMessage> loadHistoryPage();
 };
 
 #endif // CHATMESSAGESCONTROLLER_H
@@ -84,6 +84,23 @@ QHash<int, QByteArray> ChatMessagesModel::roleNames() const
 // ==========================================================================================
 // ==========================================================================================
 // ==========================================================================================
+//                                                                   HISTORY PAGES FETCHING
+void ChatMessagesModel::fetchOlderMessages()
+{
+    if (!mpMessagesController)
+    {
+        // Hold the damage if controller is not ready
+        return;
+    }
+
+    if (mpMessagesController->canFetchMoreHistory())
+    {
+        mpMessagesController->fetchMoreHistory();
+    }
+}
+// ==========================================================================================
+// ==========================================================================================
+// ==========================================================================================
 //                                                           LOCAL MESSAGES CONTROLLER GETTER
 ChatMessagesController* ChatMessagesModel::list() const
 {
@@ -119,6 +136,19 @@ void ChatMessagesModel::setList(ChatMessagesController *newController)
                 {
                     endInsertRows();
                 }, Qt::AutoConnection);
+
+        // Older history is inserted before the loaded messages
+        connect(mpMessagesController, &ChatMessagesController::preMessagesPrepended,
+                this, [=](int count)
+                {
+                    beginInsertRows(QModelIndex(), 0, count - 1);
+                }, Qt::AutoConnection);
+
+        connect(mpMessagesController, &ChatMessagesController::postMessagesPrepended,
+                this, [=]()
+                {
+                    endInsertRows();
+                }, Qt::AutoConnection);
     }
 
     endResetModel();
@@ -24,6 +24,10 @@ public:
     // Attribute names getter
     virtual QHash<int, QByteArray> roleNames() const override;
 
+    // Older history is fetched by pages only when view is scrolled to the oldest message
+    // (fetchMore isn't overridden: view calls it for its last row, which is the newest message)
+    Q_INVOKABLE void fetchOlderMessages();
+
     // Local messages controller getter & setter
     ChatMessagesController* list() const;
     void setList(ChatMessagesController *newController);
@@ -5,8 +5,11 @@
 ChatUsersController::ChatUsersController(const QString &userName, QObject *parent) :
     QObject(parent), mDatabaseUsers()
 {
-    QVector<User> superUsers = mDatabaseUsers.getAllUsersFromDb();
-    mDatabaseUsers.addUserToDb(userName);
+    // users are read once by id cache, so user is added only if database doesn't know it yet
+    if (DbIdCache::getDefaultCache().getUserId(userName).isNull())
+    {
+        mDatabaseUsers.addUserToDb(userName);
+    }
     // TODO fill chat users & implement additional states behavior
 }
 // ==========================================================================================
@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include "userdb.h"
+#include "dbidcache.h"
 #include "chatuser.h"
 
 // ==========================================================================================
@@ -16,6 +16,8 @@ const QString definitionExistsTitle     = "Cannot add definition";
 const QString successDefinCreateTitle   = "Successfull creation";
 const QString successDefinCreateMessage = "Definition was successfully created!";
 const QString definitionExistsMessage   = "Definition already exists!";
+const QString successDefinsMessage      = "Definitions were successfully created!";
+const QString allDefinsExistMessage     = "All definitions already exist!";
 const QString headerExtension           = ".h";
 const QString sourceExtension           = ".cpp";
 
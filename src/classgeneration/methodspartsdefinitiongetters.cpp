@@ -4,6 +4,59 @@
 #include "documentmanager.h"
 #include<QRegularExpression>
 #include<QDebug>
+#include<QSet>
+
+namespace
+{
+// refactoring patterns are compiled once and shared by every call
+const QRegularExpression& functionDefinitionRegex()
+{
+    static const QRegularExpression rRegex(validFucntionDefinition);
+    return rRegex;
+}
+
+const QRegularExpression& insideBracketsRegex()
+{
+    static const QRegularExpression rRegex(textInsideBracketsRegex);
+    return rRegex;
+}
+
+const QRegularExpression& classNameRegex()
+{
+    static const QRegularExpression rRegex(classFindingRegex);
+    return rRegex;
+}
+
+const QRegularExpression& variableNameRegex()
+{
+    static const QRegularExpression rRegex(getVariableFromParametrs);
+    return rRegex;
+}
+
+// key which identifies definition regardless of spaces and variables' names
+QString getDefinitionKey(const QString &methodFullName, const QString &rowParametrs)
+{
+    return QString(methodFullName).remove(' ').remove('\t') + '(' + rowParametrs + ')';
+}
+
+// collects keys of every definition-like line of the source file in one pass
+QSet<QString> getExistingDefinitionKeys(const QString &sourceText)
+{
+    QSet<QString> rKeys;
+    const auto linesStringList = sourceText.split('\n', QString::SkipEmptyParts);
+    for (const auto &line : linesStringList)
+    {
+        int bracketPosition = line.indexOf('(');
+        if (bracketPosition <= 0)
+        {
+            continue;
+        }
+        rKeys.insert(getDefinitionKey(line.left(bracketPosition),
+                                      getRowParametrsInsideBrackets(getParametrsFromMethodDefinition(line))));
+    }
+    return rKeys;
+}
+}
 
 QString getTextByCursor(QTextCursor cursor)
 {
@@ -20,8 +73,7 @@ QString getClassNameForMethodDefinition(QTextCursor cursor)
            && !textInCursorLine.contains("friend"))// if we find "class", but it's just friend class declaration
         {
             //find class name by regex
-            auto matchIter =
-                    QRegularExpression(classFindingRegex).globalMatch(getTextByCursor(cursor));
+            auto matchIter = classNameRegex().globalMatch(getTextByCursor(cursor));
             auto match = matchIter.next();
             return match.captured(1);
         }
@@ -32,14 +84,13 @@ QString getClassNameForMethodDefinition(QTextCursor cursor)
 
 bool isValidMethodInitialization(QTextCursor cursor)
 {
-    auto matchIter =
-            QRegularExpression(validFucntionDefinition).globalMatch(getTextByCursor(cursor));
+    auto matchIter = functionDefinitionRegex().globalMatch(getTextByCursor(cursor));
     return matchIter.hasNext();
 }
 
 MethodDefinitionPattern getMethodDefinitionPattern(const QString &funcDefinition)
 {
-    auto matchIter = QRegularExpression(validFucntionDefinition).globalMatch(funcDefinition);
+    auto matchIter = functionDefinitionRegex().globalMatch(funcDefinition);
     auto match = matchIter.next();
     // 1 is dataType  2 is methodName 3 is parametrs
     return MethodDefinitionPattern {match.captured(1), match.captured(2), match.captured(3)};
@@ -62,7 +113,7 @@ bool definitionExists(const QString sourceText, QTextCursor cursor)
 {
     //cursor is in the header file
     QString methodFullName = getMethodDefinitionName(cursor);
-    auto linesStringList = sourceText.split(QRegularExpression("[\n]"), QString::SkipEmptyParts);
+    auto linesStringList = sourceText.split('\n', QString::SkipEmptyParts);
     for (auto &line : linesStringList)
     {
         if (line.contains(methodFullName))
@@ -83,6 +134,55 @@ bool definitionExists(const QString sourceText, QTextCursor cursor)
     return false;
 }
 
+QStringList getMissingDefinitions(const QString &headerText, const QString &sourceText)
+{
+    auto existingKeys = getExistingDefinitionKeys(sourceText);
+    QStringList rDefinitions;
+    QString className;//class which declarations are being read now
+
+    const auto linesStringList = headerText.split('\n');
+    for (const auto &line : linesStringList)
+    {
+        if (line.contains("class") && !line.contains("friend"))
+        {
+            auto classMatch = classNameRegex().match(line);
+            if (classMatch.hasMatch())
+            {
+                if (!line.trimmed().endsWith(';'))//skip forward declarations
+                {
+                    className = classMatch.captured(1);
+                }
+                continue;
+            }
+        }
+        if (line.trimmed() == "};")//end of class body
+        {
+            className.clear();
+            continue;
+        }
+
+        auto match = functionDefinitionRegex().match(line);
+        if (!match.hasMatch())
+        {
+            continue;
+        }
+        // 1 is dataType  2 is methodName 3 is parametrs
+        MethodDefinitionPattern pattern {match.captured(1), match.captured(2), match.captured(3)};
+        QString methodFullName = pattern.mFunctionDataType + " " + className +
+                (className.isEmpty() ? QString() : "::") + pattern.mFucntionName;
+        QString definitionKey = getDefinitionKey(methodFullName,
+                                                 getRowParametrsInsideBrackets(pattern.mFunctionParametrs));
+        if (existingKeys.contains(definitionKey))
+        {
+            continue;
+        }
+        existingKeys.insert(definitionKey);//overloads declared twice get one stub
+        rDefinitions << createMethodDefinitionBones(pattern.mFunctionDataType, className,
+                                                    pattern.mFucntionName, pattern.mFunctionParametrs);
+    }
+    return rDefinitions;
+}
+
 bool isFileWithExtension(const QString &fileName, const QString &extenion)
 {
     QString rFileName(fileName);
@@ -96,7 +196,7 @@ bool isFileWithExtension(const QString &fileName, const QString &extenion)
 
 QString getParametrsFromMethodDefinition(const QString &funcDefinition)
 {
-    auto matchIter =  QRegularExpression(textInsideBracketsRegex).globalMatch(funcDefinition);
+    auto matchIter = insideBracketsRegex().globalMatch(funcDefinition);
     auto match = matchIter.next();
     return match.hasMatch() ? match.capturedTexts()[indexOfInsideBracketsCapture] : QString();
 }
@@ -110,7 +210,7 @@ QString getRowParametrsInsideBrackets(QString textInsideBrackets)
     {
         parametr = parametr.simplified();
         //find varable name
-        auto matchIter =  QRegularExpression(getVariableFromParametrs).globalMatch(parametr);
+        auto matchIter = variableNameRegex().globalMatch(parametr);
         auto match = matchIter.next();
         if (match.hasMatch())
         {
@@ -3,6 +3,7 @@
 
 #include<QString>
 #include<QTextCursor>
+#include<QStringList>
 
 struct MethodDefinitionPattern
 {
@@ -23,6 +24,9 @@ QString getParametrsFromMethodDefinition(const QString &funcDefinition);
 QString getRowParametrsInsideBrackets(QString textInsideBrackets);
 QString removeComasInsideAngleBrackets(QString functionParametrs);
 
+// returns definition bones of every header declaration which has no definition in source
+QStringList getMissingDefinitions(const QString &headerText, const QString &sourceText);
+
 bool isValidMethodInitialization(QTextCursor cursor);
 bool definitionExists(const QString documentText, QTextCursor cursor);
 bool isFileWithExtension(const QString &fileName, const QString &extenion);
@@ -1,23 +1,58 @@
 #include "accessor.h"
+#include <QStringList>
+#include <QRegExp>
 #include <QDebug>
 
-Accessor::Accessor()
+Accessor::Accessor(ConnectionMode mode)
 {
-    database = ConnectionGetter::getDefaultConnection();
+    database = ConnectionGetter::getDefaultConnection(mode);
     database->openDatabase();
-    setQuery(database->getDatabase());
 }
 
-void Accessor::setQuery(QSqlDatabase db)
+QSqlQuery& Accessor::execQuery(const QString &queryStr, const QVariantList &values)
 {
-    query = QSqlQuery(db);
-}
-
-void Accessor::execQuery(QString queryStr)
-{
-   query.prepare(queryStr);
+   QSqlQuery &query = database->getPreparedQuery(queryStr);
+   for (int i = 0; i < values.size(); ++i)
+   {
+       query.bindValue(i, values[i]);
+   }
    if (!query.exec())
       {
            qDebug()<<"not executed query";
       }
+   return query;
+}
+
+QString Accessor::toFullTextQuery(const QString &text)
+{
+    QStringList terms;
+    for (auto word : text.split(QRegExp("\\s+"), QString::SkipEmptyParts))
+    {
+        terms << "\"" + word.replace("\"", "\"\"") + "\"";
+    }
+    if (!terms.isEmpty())
+    {
+        terms.last() += "*";
+    }
+    return terms.join(" ");
+}
+
+bool Accessor::beginTransaction()
+{
+    return database->getDatabase().transaction();
+}
+
+bool Accessor::commitTransaction()
+{
+    if (!database->getDatabase().commit())
+    {
+        qDebug()<<"not committed transaction";
+        return false;
+    }
+    return true;
+}
+
+void Accessor::rollbackTransaction()
+{
+    database->getDatabase().rollback();
 }
@@ -5,12 +5,20 @@
 class Accessor
 {
 public:
-    Accessor();
+    explicit Accessor(ConnectionMode mode = ConnectionMode::ReadWrite);
     ~Accessor()= default;
 protected:
-    void setQuery(QSqlDatabase db);
-    void execQuery(QString query);
-    QSqlQuery query;
+    // query is prepared once per connection & executed with values bound to its '?' placeholders,
+    // returned query is shared by accessors, so its result is read & finished before next query
+    QSqlQuery& execQuery(const QString &queryStr, const QVariantList &values = QVariantList());
+    // several queries are written to disk at once, caller rolls transaction back
+    // when any of them fails, so either all of them are applied or none
+    bool beginTransaction();
+    bool commitTransaction();
+    void rollbackTransaction();
+    // text typed by user is turned into full-text query which matches rows
+    // containing all its words (the last one as prefix), so its symbols aren't parsed as syntax
+    static QString toFullTextQuery(const QString &text);
 private:
     Connection *database;
 };
@@ -1,47 +1,114 @@
 #include "commentdb.h"
+#include "dbidcache.h"
 #include <QDebug>
-CommentDb::CommentDb(): Accessor()
+CommentDb::CommentDb(ConnectionMode mode): Accessor(mode)
 {
 }
 
 CommentDb::~CommentDb()
 {
-    query.finish();
 }
 
 void CommentDb::addCommentsToDb(const QVector<Comment> &comments)
 {
     for (auto &i : comments)
     {
-        execQuery(addCommentQuery(i));
+        execQuery(addCommentQuery(), {i.mLine, DbIdCache::getDefaultCache().getFileId(i.mFile),
+                                      DbIdCache::getDefaultCache().getUserId(i.mUser), i.mText}).finish();
     }
-    query.finish();
 }
 
 void CommentDb::deleteCommentFromDb(const int commentLine, const QString commentFile)
 {
-    execQuery(deleteCommentQuery(commentLine, commentFile));
-    query.finish();
+    execQuery(deleteCommentQuery(), {DbIdCache::getDefaultCache().getFileId(commentFile), commentLine}).finish();
 }
 
 void CommentDb::deleteCommentsFromDb(const QString& commentFile)
 {
-    execQuery(deleteAllCommentsInFileQuery(commentFile));
+    execQuery(deleteAllCommentsInFileQuery(), {DbIdCache::getDefaultCache().getFileId(commentFile)}).finish();
+}
+
+void CommentDb::writeCommentsChanges(const QVector<Comment> &changedComments,
+                                     const QVector<Comment> &removedComments)
+{
+    if (changedComments.isEmpty() && removedComments.isEmpty())
+    {
+        return;
+    }
+
+    const bool transactionStarted = beginTransaction();
+    bool success = true;
+    for (auto &i : commentsChangesStatements(changedComments, removedComments))
+    {
+        QSqlQuery &query = execQuery(i.mQuery, i.mValues);
+        success = query.isActive();
+        query.finish();
+        if (!success)
+        {
+            break;
+        }
+    }
+    // comments are written entirely or not at all
+    if (transactionStarted && (!success || !commitTransaction()))
+    {
+        rollbackTransaction();
+    }
+}
+
+std::future<bool> CommentDb::writeCommentsChangesAsync(const QVector<Comment> &changedComments,
+                                                       const QVector<Comment> &removedComments)
+{
+    QStringList keys;
+    for (const auto &comments : {changedComments, removedComments})
+    {
+        for (auto &i : comments)
+        {
+            const QString key = commentsWriteKey(i.mFile);
+            if (!keys.contains(key))
+            {
+                keys << key;
+            }
+        }
+    }
+    return DbWriter::getDefaultWriter()->write(commentsChangesStatements(changedComments, removedComments), keys);
+}
+
+QVector<DbWriter::Statement> CommentDb::commentsChangesStatements(const QVector<Comment> &changedComments,
+                                                                  const QVector<Comment> &removedComments)
+{
+    // comment moved to another line is removed from previous one first
+    DbIdCache &idCache = DbIdCache::getDefaultCache();
+    QVector<DbWriter::Statement> rStatements;
+    for (auto &i : removedComments)
+    {
+        rStatements.push_back(DbWriter::Statement {deleteCommentQuery(), {idCache.getFileId(i.mFile), i.mLine}});
+    }
+    for (auto &i : changedComments)
+    {
+        rStatements.push_back(DbWriter::Statement {upsertCommentQuery(),
+                                                   {i.mLine, idCache.getFileId(i.mFile),
+                                                    idCache.getUserId(i.mUser), i.mText}});
+    }
+    return rStatements;
 }
 
 QVector<Comment> CommentDb::getAllCommentsFromFile(const QString filename)
 {
-      execQuery(numberOfCommentInFileQuery(filename));
-      query.first();
-      int count_of_messages =query.value(0).toInt();
-      qDebug()<<count_of_messages;
-      QVector<Comment> comments(count_of_messages);
-      execQuery(allCommentInFileQuery(filename));
-      int counter = 0;
+      // comments of file which are being written by writer thread are read too,
+      // other writes aren't waited for
+      DbWriter::getDefaultWriter()->waitForKey(commentsWriteKey(filename));
+      QVector<Comment> comments;
+      const QVariant fileId = DbIdCache::getDefaultCache().getFileId(filename);
+      if (fileId.isNull())
+      {
+          return comments;
+      }
+      QSqlQuery &query = execQuery(allCommentInFileQuery(), {fileId});
       while (query.next())
       {
-          fillStructComment(comments[counter]);
-          counter++;
+          Comment comment;
+          fillStructComment(query, comment);
+          comments.push_back(comment);
       }
       query.finish();
       return comments;
@@ -49,70 +116,95 @@ QVector<Comment> CommentDb::getAllCommentsFromFile(const QString filename)
 
 Comment CommentDb::getCommentFromDb(const int commentLine, const QString commentFile)
 {
-    execQuery(getCommentQuery(commentLine, commentFile));
-    query.first();
+    QSqlQuery &query = execQuery(getCommentQuery(), {commentFile, commentLine});
     Comment rComment;
-    fillStructComment(rComment);
+    if (query.first())
+    {
+        fillStructComment(query, rComment);
+    }
     query.finish();
     return rComment;
 }
 
-QString CommentDb::addCommentQuery(const Comment &comment)
+QVector<Comment> CommentDb::searchCommentsInDb(const QString &text, const int offset, const int pageSize)
 {
-    return "INSERT INTO Comment (line, idFile, idUser, text) VALUES ('"
-            +QString::number(comment.mLine) + "', "
-            "(SELECT id FROM File WHERE name = '" + comment.mFile + "'), "
-            "(SELECT id FROM User WHERE nickname = '" + comment.mUser + "'), '"
-            +comment.mText + "')" ;
+    QVector<Comment> comments;
+    const QString fullTextQuery = toFullTextQuery(text);
+    if (fullTextQuery.isEmpty())
+    {
+        return comments;
+    }
+
+    // committed comments are searched, reader doesn't wait for writer
+    QSqlQuery &query = execQuery(searchCommentsQuery(), {fullTextQuery, pageSize, offset});
+    while (query.next())
+    {
+        Comment comment;
+        fillStructComment(query, comment);
+        comments.push_back(comment);
+    }
+    query.finish();
+    return comments;
 }
 
-QString CommentDb::deleteCommentQuery(const int commentLine, const QString commentFile)
+QString CommentDb::addCommentQuery()
 {
-    return "DELETE FROM Comment WHERE idFile ="
-            "(SELECT id FROM File where name = "
-            + commentFile
-            +") AND line = " +
-            QString::number(commentLine);
+    return "INSERT INTO Comment (line, idFile, idUser, text) VALUES (?, ?, ?, ?)";
 }
 
-
-QString CommentDb::getCommentQuery(const int commentLine, const QString commentFile)
+QString CommentDb::upsertCommentQuery()
 {
-    return "SELECT * FROM Comment WHERE idFile = "
-           "(SELECT id FROM File where name = "
-            + commentFile
-            + ") AND line = " +
-            QString::number(commentLine);
+    // comment is identified by its line & file
+    return "INSERT OR REPLACE INTO Comment (line, idFile, idUser, text) VALUES (?, ?, ?, ?)";
 }
 
-void CommentDb::fillStructComment(Comment &comment)
+QString CommentDb::deleteCommentQuery()
 {
-    comment.mLine = query.record().value(0).toInt();
-    comment.mText = query.record().value(1).toString();
-    comment.mUser = query.record().value(2).toString();
-    comment.mFile = query.record().value(3).toString();
-    qDebug()<<comment.mText;
+    return "DELETE FROM Comment WHERE idFile = ? AND line = ?";
 }
 
-QString CommentDb::numberOfCommentInFileQuery(const QString filename)
+
+QString CommentDb::getCommentQuery()
 {
-    return "Select Count(Comment.line) "
+    return "Select Comment.line, Comment.text, User.nickname, File.name "
            "from Comment inner join User on User.id=Comment.idUser "
             "inner join File on File.id=Comment.idFile "
-            "where Comment.idFile = (Select File.ID from File where file.name = '"
-            + filename + "')";
+            "where File.name = ? and Comment.line = ?";
 }
 
-QString CommentDb::allCommentInFileQuery(const QString filename)
+void CommentDb::fillStructComment(const QSqlQuery &query, Comment &comment)
 {
+    comment.mLine = query.value(0).toInt();
+    comment.mText = query.value(1).toString();
+    comment.mUser = query.value(2).toString();
+    comment.mFile = query.value(3).toString();
+    qDebug()<<comment.mText;
+}
+
+QString CommentDb::allCommentInFileQuery()
+{
+    // comments of file are read by index of Comment (idFile)
     return "Select Comment.line, Comment.text, User.nickname, File.name "
-           "from Comment inner join User on User.id=Comment.idUser "
-            "inner join File on File.id=Comment.idFile "
-            "where Comment.idFile = (Select File.ID from File where file.name = '"
-            + filename + "')";
+           "from Comment inner join File on File.id = Comment.idFile "
+            "inner join User on User.id = Comment.idUser "
+            "where Comment.idFile = ?";
+}
+
+QString CommentDb::searchCommentsQuery()
+{
+    return "Select Comment.line, Comment.text, User.nickname, File.name "
+           "from CommentSearch inner join Comment on Comment.id = CommentSearch.rowid "
+            "inner join File on File.id = Comment.idFile "
+            "inner join User on User.id = Comment.idUser "
+            "where CommentSearch match ? order by CommentSearch.rank limit ? offset ?";
+}
+
+QString CommentDb::deleteAllCommentsInFileQuery()
+{
+    return "Delete from Comment where Comment.idFile = ?";
 }
 
-QString CommentDb::deleteAllCommentsInFileQuery(const QString filename)
+QString CommentDb::commentsWriteKey(const QString &fileName)
 {
-    return "Delete from Comment where Comment.idFile = (Select id from File where name = '" + filename + "')";
+    return "comments:" + fileName;
 }
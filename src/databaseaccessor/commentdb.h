@@ -2,25 +2,38 @@
 #define COMMENTDB_H
 #include "accessor.h"
 #include "structsfordb.h"
+#include "dbwriter.h"
 
 class CommentDb : public Accessor
 {
 public:
-    CommentDb();
+    explicit CommentDb(ConnectionMode mode = ConnectionMode::ReadWrite);
     ~CommentDb();
     void addCommentsToDb(const QVector<Comment> &comments);
     void deleteCommentFromDb(const int commentLine, const QString commentFile);
     void deleteCommentsFromDb(const QString& commentFile);
+    // changed & added comments are upserted & removed ones are deleted in one transaction
+    void writeCommentsChanges(const QVector<Comment> &changedComments, const QVector<Comment> &removedComments);
+    // the same changes are committed by writer thread
+    std::future<bool> writeCommentsChangesAsync(const QVector<Comment> &changedComments,
+                                                const QVector<Comment> &removedComments);
     QVector <Comment> getAllCommentsFromFile(const QString filename);
     Comment getCommentFromDb(const int commentLine, const QString commentFile);
+    // comments which contain words of text, the most relevant first
+    QVector <Comment> searchCommentsInDb(const QString &text, const int offset, const int pageSize);
 private:
-    QString addCommentQuery(const Comment& comment);
-    QString deleteCommentQuery(const int commentLine, const QString commentFile);
-    QString getCommentQuery(const int commentLine, const QString commentFile);
-    void fillStructComment(Comment &comment);
-    QString numberOfCommentInFileQuery(const QString filename);
-    QString allCommentInFileQuery(const QString filename);
-    QString deleteAllCommentsInFileQuery(const QString commentFile);
+    QString addCommentQuery();
+    QString upsertCommentQuery();
+    QVector<DbWriter::Statement> commentsChangesStatements(const QVector<Comment> &changedComments,
+                                                           const QVector<Comment> &removedComments);
+    QString deleteCommentQuery();
+    QString getCommentQuery();
+    void fillStructComment(const QSqlQuery &query, Comment &comment);
+    QString allCommentInFileQuery();
+    QString deleteAllCommentsInFileQuery();
+    QString searchCommentsQuery();
+    // key of writes which change comments of file
+    QString commentsWriteKey(const QString &fileName);
 };
 
 #endif // COMMENTDB_H
@@ -1,21 +1,42 @@
 #include "connection.h"
+#include "connectiongetter.h"
 #include <QDebug>
 
-Connection::Connection()
+Connection::Connection(const QString &connectionName, bool readOnly):
+    mConnectionName(connectionName),
+    mReadOnly(readOnly)
 {
-     mDb = QSqlDatabase::addDatabase(typeDatabase);
+     mDb = QSqlDatabase::addDatabase(typeDatabase, mConnectionName);
 }
 
 Connection::~Connection()
 {
+    mPreparedQueries.clear();
+    mpUnpreparedQuery.reset();
     mDb.close();
+    // connection can be removed only when no handle to it is left
+    mDb = QSqlDatabase();
+    QSqlDatabase::removeDatabase(mConnectionName);
 }
 
 void Connection::openDatabase()
 {
-    mDb = QSqlDatabase::database();
-    mDb.setDatabaseName(mPath);
-    mDb.open();
+    // reopening would invalidate prepared queries, so it's done only for another database
+    const QString path = ConnectionGetter::getDatabasePath();
+    if (mDb.isOpen() && mDb.databaseName() == path)
+    {
+        return;
+    }
+    mPreparedQueries.clear();
+    mpUnpreparedQuery.reset();
+    mDb.close();
+    mDb.setDatabaseName(path);
+    mDb.setConnectOptions(mReadOnly ? "QSQLITE_OPEN_READONLY" : "");
+    if (mDb.open())
+    {
+        QSqlQuery(mDb).exec(DB_SYNCHRONOUS_PRAGMA);
+        QSqlQuery(mDb).exec(DB_RECURSIVE_TRIGGERS_PRAGMA);
+    }
 }
 
 QSqlDatabase Connection::getDatabase()
@@ -23,10 +44,26 @@ QSqlDatabase Connection::getDatabase()
     return mDb;
 }
 
-QString Connection::mPath = "";
-
-QString Connection::getPath()
+QSqlQuery& Connection::getPreparedQuery(const QString &queryStr)
 {
-    return mPath;
+    auto it = mPreparedQueries.find(queryStr);
+    if (it != mPreparedQueries.end())
+    {
+        return *it.value();
+    }
+
+    std::shared_ptr<QSqlQuery> pQuery = std::make_shared<QSqlQuery>(mDb);
+    if (!pQuery->prepare(queryStr))
+    {
+        // failed query isn't cached, so it's prepared again next time (e.g. its table is created later)
+        qDebug()<<"not prepared query";
+        mpUnpreparedQuery = pQuery;
+        return *mpUnpreparedQuery;
+    }
+    return *mPreparedQueries.insert(queryStr, pQuery).value();
 }
 
+bool Connection::isReadOnly() const
+{
+    return mReadOnly;
+}
@@ -4,21 +4,35 @@
 #include <QtSql/QSqlQuery>
 #include <QtSql/QSqlRecord>
 #include <QVariant>
+#include <QHash>
+#include <memory>
 
+// commits of WAL database are synced at checkpoints only, so they don't wait for disk
+const char *const DB_SYNCHRONOUS_PRAGMA = "PRAGMA synchronous = NORMAL";
+// rows replaced by INSERT OR REPLACE fire delete triggers, so full-text indexes stay in sync
+const char *const DB_RECURSIVE_TRIGGERS_PRAGMA = "PRAGMA recursive_triggers = ON";
+
+// named connection of one thread to project database, is given by ConnectionGetter
 class Connection
 {
 public:
+    // database is (re)opened only when project database of pool was changed
     void openDatabase();
     ~Connection();
     QSqlDatabase getDatabase();
-    static QString getPath();
-    void close();
+    bool isReadOnly() const;
+    // query of every shape is compiled once & reused by all accessors of connection
+    QSqlQuery& getPreparedQuery(const QString &queryStr);
 private:
-    Connection();
+    Connection(const QString &connectionName, bool readOnly);
 
-    static QString mPath;
+    QString mConnectionName;
+    bool mReadOnly;
     QSqlDatabase mDb;
     const QString typeDatabase = "QSQLITE";
+    // queries are kept by pointers, so references to them stay valid when new ones are added
+    QHash<QString, std::shared_ptr<QSqlQuery>> mPreparedQueries;
+    std::shared_ptr<QSqlQuery> mpUnpreparedQuery;
     friend class ConnectionGetter;
 };
 
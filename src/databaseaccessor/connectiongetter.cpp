@@ -1,13 +1,84 @@
 #include "connectiongetter.h"
+#include "dbwriter.h"
+#include <QThreadStorage>
+#include <QMutexLocker>
+#include <QThread>
+#include <QMutex>
+#include <memory>
+
+namespace
+{
+
+struct ThreadConnections
+{
+    std::unique_ptr<Connection> mpReadWrite;
+    std::unique_ptr<Connection> mpReadOnly;
+};
+
+// connections are deleted by thread storage on exit of their thread
+QThreadStorage<ThreadConnections*>& getThreadConnections()
+{
+    static QThreadStorage<ThreadConnections*> threadConnections;
+    return threadConnections;
+}
+
+QMutex& getPathMutex()
+{
+    static QMutex pathMutex;
+    return pathMutex;
+}
+
+QString& getPath()
+{
+    static QString path;
+    return path;
+}
+
+}
 
 Connection* ConnectionGetter::getDefaultConnection(const QString &path)
 {
-    Connection::mPath = path;
+    // writes queued for previous database are committed to it before writer reopens its connection
+    if (getDatabasePath() != path)
+    {
+        DbWriter::getDefaultWriter()->waitForDone();
+    }
+    {
+        QMutexLocker locker(&getPathMutex());
+        getPath() = path;
+    }
     return getDefaultConnection();
 }
 
-Connection *ConnectionGetter::getDefaultConnection()
+Connection *ConnectionGetter::getDefaultConnection(ConnectionMode mode)
+{
+    QThreadStorage<ThreadConnections*> &threadConnections = getThreadConnections();
+    if (!threadConnections.hasLocalData())
+    {
+        threadConnections.setLocalData(new ThreadConnections);
+    }
+
+    const bool readOnly = mode == ConnectionMode::ReadOnly;
+    std::unique_ptr<Connection> &pConnection = readOnly ? threadConnections.localData()->mpReadOnly
+                                                        : threadConnections.localData()->mpReadWrite;
+    if (!pConnection)
+    {
+        // name is unique among running threads, connections of finished ones are already removed
+        const QString connectionName = QString("projectDb_%1_%2")
+                .arg(reinterpret_cast<quintptr>(QThread::currentThreadId()))
+                .arg(readOnly ? "ro" : "rw");
+        pConnection.reset(new Connection(connectionName, readOnly));
+    }
+    return pConnection.get();
+}
+
+QString ConnectionGetter::getDatabasePath()
+{
+    QMutexLocker locker(&getPathMutex());
+    return getPath();
+}
+
+void ConnectionGetter::closeThreadConnections()
 {
-    static Connection *defaultConn = new Connection();
-    return defaultConn;
+    getThreadConnections().setLocalData(nullptr);
 }
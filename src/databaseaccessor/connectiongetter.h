@@ -2,12 +2,28 @@
 #define CONNECTIONGETTER_H
 #include "connection.h"
 
+enum class ConnectionMode
+{
+    ReadWrite,
+    // for readers (search, indexing, history loading), which can't change database by mistake
+    ReadOnly
+};
+
+// pool of connections to project database: Qt connection can be used only by thread
+// which created it, so every thread gets its own named connections, which are closed
+// when thread exits, & all of them open the same database file
 class ConnectionGetter
 {
     ConnectionGetter() = default;
 public:
+    // project database of connections of all threads (writer included) is set,
+    // writes queued for previous one are committed to it first
     static Connection* getDefaultConnection(const QString &path);
-    static Connection* getDefaultConnection();
+    // connection of calling thread
+    static Connection* getDefaultConnection(ConnectionMode mode = ConnectionMode::ReadWrite);
+    static QString getDatabasePath();
+    // connections of calling thread are closed before it exits
+    static void closeThreadConnections();
 };
 
 #endif // CONNECTIONGETTER_H
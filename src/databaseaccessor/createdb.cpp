@@ -7,27 +7,137 @@ CreateDB::CreateDB(): Accessor ()
 
 CreateDB::~CreateDB()
 {
-    query.finish();
 }
 
 void CreateDB::addTableUser()
 {
-    execQuery(tableUserQuery());
+    execQuery(tableUserQuery()).finish();
 }
 
 void CreateDB::addTableMessage()
 {
-    execQuery(tableMessageQuery());
+    execQuery(tableMessageQuery()).finish();
 }
 
 void CreateDB::addTableComment()
 {
-    execQuery(tableCommentQuery());
+    execQuery(tableCommentQuery()).finish();
 }
 
 void CreateDB::addTableFile()
 {
-    execQuery(tableFileQuery());
+    execQuery(tableFileQuery()).finish();
+}
+
+void CreateDB::migrateSchema()
+{
+    // readers aren't blocked while writer thread commits
+    execQuery("PRAGMA journal_mode = WAL").finish();
+
+    QSqlQuery &versionQuery = execQuery("PRAGMA user_version");
+    const int version = versionQuery.first() ? versionQuery.value(0).toInt() : 0;
+    versionQuery.finish();
+
+    const QVector<QStringList> schemaMigrations = migrations();
+    for (int i = version; i < schemaMigrations.size(); ++i)
+    {
+        // migration is applied entirely or not at all
+        const bool transactionStarted = beginTransaction();
+        bool success = true;
+        QStringList migrationQueries = schemaMigrations[i];
+        migrationQueries.push_back("PRAGMA user_version = " + QString::number(i + 1));
+        for (const auto &migrationQuery : migrationQueries)
+        {
+            QSqlQuery &query = execQuery(migrationQuery);
+            success = query.isActive() && success;
+            query.finish();
+        }
+        if (!success || (transactionStarted && !commitTransaction()))
+        {
+            qDebug()<<"schema is not migrated";
+            rollbackTransaction();
+            return;
+        }
+    }
+}
+
+QVector<QStringList> CreateDB::migrations()
+{
+    // every step brings schema to the next version, applied steps are never changed
+    return QVector<QStringList>
+    {
+        // chat history is read by time, comments are read by file (name of file is unique, so it's indexed)
+        {
+            "CREATE INDEX IF NOT EXISTS MessageTimeIndex ON Message (time, id)",
+            "CREATE INDEX IF NOT EXISTS CommentFileIndex ON Comment (idFile)"
+        },
+        // full-text indexes of chat messages & comments refer to rows of their tables
+        // & are kept in sync by triggers, existing rows are indexed by rebuild
+        {
+            "CREATE VIRTUAL TABLE IF NOT EXISTS MessageSearch USING fts5 "
+            "(messageText, content = 'Message', content_rowid = 'id')",
+            "CREATE TRIGGER IF NOT EXISTS MessageSearchInsert AFTER INSERT ON Message BEGIN "
+            "INSERT INTO MessageSearch (rowid, messageText) VALUES (new.id, new.messageText); END",
+            "CREATE TRIGGER IF NOT EXISTS MessageSearchDelete AFTER DELETE ON Message BEGIN "
+            "INSERT INTO MessageSearch (MessageSearch, rowid, messageText) "
+            "VALUES ('delete', old.id, old.messageText); END",
+            "CREATE TRIGGER IF NOT EXISTS MessageSearchUpdate AFTER UPDATE OF messageText ON Message BEGIN "
+            "INSERT INTO MessageSearch (MessageSearch, rowid, messageText) "
+            "VALUES ('delete', old.id, old.messageText); "
+            "INSERT INTO MessageSearch (rowid, messageText) VALUES (new.id, new.messageText); END",
+            "INSERT INTO MessageSearch (MessageSearch) VALUES ('rebuild')",
+
+            "CREATE VIRTUAL TABLE IF NOT EXISTS CommentSearch USING fts5 "
+            "(text, content = 'Comment', content_rowid = 'rowid')",
+            "CREATE TRIGGER IF NOT EXISTS CommentSearchInsert AFTER INSERT ON Comment BEGIN "
+            "INSERT INTO CommentSearch (rowid, text) VALUES (new.rowid, new.text); END",
+            "CREATE TRIGGER IF NOT EXISTS CommentSearchDelete AFTER DELETE ON Comment BEGIN "
+            "INSERT INTO CommentSearch (CommentSearch, rowid, text) VALUES ('delete', old.rowid, old.text); END",
+            "CREATE TRIGGER IF NOT EXISTS CommentSearchUpdate AFTER UPDATE OF text ON Comment BEGIN "
+            "INSERT INTO CommentSearch (CommentSearch, rowid, text) VALUES ('delete', old.rowid, old.text); "
+            "INSERT INTO CommentSearch (rowid, text) VALUES (new.rowid, new.text); END",
+            "INSERT INTO CommentSearch (CommentSearch) VALUES ('rebuild')"
+        },
+        // renamed or moved file is found by its identity, so its comments are kept
+        {
+            "ALTER TABLE File ADD COLUMN fileKey TEXT",
+            "ALTER TABLE File ADD COLUMN fingerprint TEXT",
+            "CREATE INDEX IF NOT EXISTS FileKeyIndex ON File (fileKey)",
+            "CREATE INDEX IF NOT EXISTS FileFingerprintIndex ON File (fingerprint)"
+        },
+        // full-text index of comments refers to their explicit id, as implicit rowid can be renumbered by VACUUM,
+        // so comments are moved to table with id & index is created again
+        {
+            "DROP TRIGGER IF EXISTS CommentSearchInsert",
+            "DROP TRIGGER IF EXISTS CommentSearchDelete",
+            "DROP TRIGGER IF EXISTS CommentSearchUpdate",
+            "DROP TABLE IF EXISTS CommentSearch",
+            "CREATE TABLE CommentWithId ("
+            "id     INTEGER  PRIMARY KEY AUTOINCREMENT, "
+            "line   INT, "
+            "idFile          REFERENCES File (ID) NOT NULL, "
+            "idUser INTEGER  REFERENCES User (id) NOT NULL, "
+            "text   TEXT, "
+            "time   DATETIME DEFAULT (datetime('now') ), "
+            "UNIQUE (line, idFile))",
+            "INSERT INTO CommentWithId (line, idFile, idUser, text, time) "
+            "SELECT line, idFile, idUser, text, time FROM Comment",
+            "DROP TABLE Comment",
+            "ALTER TABLE CommentWithId RENAME TO Comment",
+            "CREATE INDEX IF NOT EXISTS CommentFileIndex ON Comment (idFile)",
+
+            "CREATE VIRTUAL TABLE CommentSearch USING fts5 "
+            "(text, content = 'Comment', content_rowid = 'id')",
+            "CREATE TRIGGER CommentSearchInsert AFTER INSERT ON Comment BEGIN "
+            "INSERT INTO CommentSearch (rowid, text) VALUES (new.id, new.text); END",
+            "CREATE TRIGGER CommentSearchDelete AFTER DELETE ON Comment BEGIN "
+            "INSERT INTO CommentSearch (CommentSearch, rowid, text) VALUES ('delete', old.id, old.text); END",
+            "CREATE TRIGGER CommentSearchUpdate AFTER UPDATE OF text ON Comment BEGIN "
+            "INSERT INTO CommentSearch (CommentSearch, rowid, text) VALUES ('delete', old.id, old.text); "
+            "INSERT INTO CommentSearch (rowid, text) VALUES (new.id, new.text); END",
+            "INSERT INTO CommentSearch (CommentSearch) VALUES ('rebuild')"
+        }
+    };
 }
 
 QString CreateDB::tableUserQuery()
@@ -49,17 +159,18 @@ QString CreateDB::tableMessageQuery()
 QString CreateDB::tableCommentQuery()
 {
     return "CREATE TABLE IF NOT EXISTS Comment ("
+        "id     INTEGER  PRIMARY KEY AUTOINCREMENT, "
         "line   INT, "
         "idFile          REFERENCES File (ID) NOT NULL, "
         "idUser INTEGER  REFERENCES User (id) NOT NULL, "
         "text   TEXT, "
         "time   DATETIME DEFAULT (datetime('now') ), "
-        "PRIMARY KEY (line, idFile))";
+        "UNIQUE (line, idFile))";
 }
 
 QString CreateDB::tableFileQuery()
 {
     return "CREATE TABLE IF NOT EXISTS File ("
         "id   INTEGER      PRIMARY KEY AUTOINCREMENT, "
-        "name VARCHAR (50) UNIQUE)";
+        "name TEXT         UNIQUE)";
 }
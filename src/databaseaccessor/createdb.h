@@ -1,6 +1,8 @@
 #ifndef CREATEDB_H
 #define CREATEDB_H
 #include "accessor.h"
+#include <QStringList>
+#include <QVector>
 
 class CreateDB: public Accessor
 {
@@ -11,7 +13,11 @@ public:
     void addTableMessage();
     void addTableComment();
     void addTableFile();
+    // enables WAL journal & applies schema changes which database doesn't have yet,
+    // version of schema is kept in user_version of database
+    void migrateSchema();
 private:
+    QVector<QStringList> migrations();
     QString tableUserQuery();
     QString tableMessageQuery();
     QString tableCommentQuery();
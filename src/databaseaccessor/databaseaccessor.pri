@@ -7,6 +7,9 @@ HEADERS += \
     $$PWD/connection.h \
     $$PWD/connectiongetter.h \
     $$PWD/createdb.h \
+    $$PWD/dbidcache.h \
+    $$PWD/dbwriter.h \
+    $$PWD/fileidentity.h \
     $$PWD/filedb.h \
     $$PWD/messagedb.h \
     $$PWD/sqliteaccess.h \
@@ -19,6 +22,9 @@ SOURCES += \
     $$PWD/connection.cpp \
     $$PWD/connectiongetter.cpp \
     $$PWD/createdb.cpp \
+    $$PWD/dbidcache.cpp \
+    $$PWD/dbwriter.cpp \
+    $$PWD/fileidentity.cpp \
     $$PWD/filedb.cpp \
     $$PWD/messagedb.cpp \
     $$PWD/userdb.cpp
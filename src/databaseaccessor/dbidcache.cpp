@@ -0,0 +1,90 @@
+#include "dbidcache.h"
+#include "connectiongetter.h"
+#include "filedb.h"
+#include "userdb.h"
+#include <QMutexLocker>
+
+DbIdCache& DbIdCache::getDefaultCache()
+{
+    static DbIdCache defaultCache;
+    return defaultCache;
+}
+
+QVariant DbIdCache::getUserId(const QString &nickname)
+{
+    QMutexLocker locker(&mMutex);
+    ensureCurrentDatabase();
+
+    // there are few users, so all of them are read by one query
+    if (!mUsersLoaded)
+    {
+        for (const auto &user : UserDb().getAllUsersFromDb())
+        {
+            mUserIds.insert(user.mNickname, user.mId);
+        }
+        mUsersLoaded = true;
+    }
+
+    auto it = mUserIds.find(nickname);
+    if (it == mUserIds.end())
+    {
+        // user could be added after users were read
+        const int id = UserDb().getUserIdFromDb(nickname);
+        if (!id)
+        {
+            return QVariant();
+        }
+        it = mUserIds.insert(nickname, id);
+    }
+    return it.value();
+}
+
+QVariant DbIdCache::getFileId(const QString &fileName)
+{
+    QMutexLocker locker(&mMutex);
+    ensureCurrentDatabase();
+
+    // files are read one by one when their comments are needed
+    auto it = mFileIds.find(fileName);
+    if (it == mFileIds.end())
+    {
+        const int id = FileDb().resolveFileIdFromDb(fileName);
+        if (!id)
+        {
+            return QVariant();
+        }
+        // previous name of moved file doesn't refer to it anymore
+        auto idIt = mFileIds.begin();
+        while (idIt != mFileIds.end())
+        {
+            if (idIt.value() == id)
+            {
+                idIt = mFileIds.erase(idIt);
+            }
+            else
+            {
+                ++idIt;
+            }
+        }
+        it = mFileIds.insert(fileName, id);
+    }
+    return it.value();
+}
+
+void DbIdCache::forgetFile(const QString &fileName)
+{
+    QMutexLocker locker(&mMutex);
+    mFileIds.remove(fileName);
+}
+
+void DbIdCache::ensureCurrentDatabase()
+{
+    const QString databasePath = ConnectionGetter::getDatabasePath();
+    if (mDatabasePath != databasePath)
+    {
+        mDatabasePath = databasePath;
+        mUsersLoaded = false;
+        mUserIds.clear();
+        mFileIds.clear();
+    }
+}
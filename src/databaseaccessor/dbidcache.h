@@ -0,0 +1,39 @@
+#ifndef DBIDCACHE_H
+#define DBIDCACHE_H
+#include <QVariant>
+#include <QString>
+#include <QMutex>
+#include <QHash>
+
+// ids of users & files of project database are resolved once & kept in memory,
+// so writes of comments & messages bind ids instead of looking them up by name
+// (cache is shared by all threads, ids are resolved before writes are queued to writer thread),
+// file which was renamed or moved keeps its id, as it's found by its identity
+class DbIdCache
+{
+public:
+    static DbIdCache& getDefaultCache();
+
+    // null is returned if there is no such user or file
+    QVariant getUserId(const QString &nickname);
+    QVariant getFileId(const QString &fileName);
+    // file was removed or renamed in database or changed on disk,
+    // so its id is resolved again (by its identity if it was moved)
+    void forgetFile(const QString &fileName);
+
+private:
+    DbIdCache() = default;
+
+    // ids belong to database they were read from, so they're dropped when another is opened,
+    // is called under mutex
+    void ensureCurrentDatabase();
+
+    // ids missing in cache are read under it too, so every id is resolved once
+    QMutex mMutex;
+    QString mDatabasePath;
+    bool mUsersLoaded = false;
+    QHash<QString, int> mUserIds;
+    QHash<QString, int> mFileIds;
+};
+
+#endif // DBIDCACHE_H
@@ -0,0 +1,200 @@
+#include "dbwriter.h"
+#include "connectiongetter.h"
+#include <QtSql/QSqlQuery>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QDebug>
+
+namespace
+{
+
+// every write of batch is applied entirely or not at all
+const char *writeSavepointQuery = "SAVEPOINT dbWriterWrite";
+const char *releaseWriteQuery = "RELEASE dbWriterWrite";
+const char *rollbackWriteQuery = "ROLLBACK TO dbWriterWrite";
+
+}
+
+DbWriter* DbWriter::getDefaultWriter()
+{
+    // writer outlives editors, so comments written on their destruction are committed
+    static DbWriter defaultWriter;
+    return &defaultWriter;
+}
+
+DbWriter::DbWriter():
+    mLastQueuedNumber(0),
+    mLastCommittedNumber(0),
+    mKeyWaitersCount(0),
+    mBatchInProgress(false),
+    mStopRequested(false)
+{
+}
+
+DbWriter::~DbWriter()
+{
+    // queued writes are committed before thread is finished
+    {
+        QMutexLocker locker(&mMutex);
+        mStopRequested = true;
+        mWritesQueued.wakeAll();
+    }
+    wait();
+}
+
+std::future<bool> DbWriter::write(const QVector<Statement> &statements, const QStringList &keys)
+{
+    QMutexLocker locker(&mMutex);
+    Write newWrite {statements, std::make_shared<std::promise<bool>>(), ++mLastQueuedNumber};
+    std::future<bool> rResult = newWrite.mpResult->get_future();
+    for (const auto &key : keys)
+    {
+        mLastWriteByKey.insert(key, newWrite.mNumber);
+    }
+    mQueue.push_back(newWrite);
+    if (!isRunning())
+    {
+        start();
+    }
+    mWritesQueued.wakeAll();
+    return rResult;
+}
+
+void DbWriter::waitForKey(const QString &key)
+{
+    QMutexLocker locker(&mMutex);
+    const quint64 writeNumber = mLastWriteByKey.value(key);
+    if (!writeNumber)
+    {
+        return;
+    }
+
+    ++mKeyWaitersCount;
+    mWritesQueued.wakeAll();
+    while (mLastCommittedNumber < writeNumber)
+    {
+        mWritesCommitted.wait(&mMutex);
+    }
+    --mKeyWaitersCount;
+}
+
+void DbWriter::waitForDone()
+{
+    QMutexLocker locker(&mMutex);
+    while (!mQueue.isEmpty() || mBatchInProgress)
+    {
+        mWritesCommitted.wait(&mMutex);
+    }
+}
+
+void DbWriter::run()
+{
+    // project database is set in pool, so writes follow the one which other threads read
+    Connection *pConnection = ConnectionGetter::getDefaultConnection();
+
+    QMutexLocker locker(&mMutex);
+    while (true)
+    {
+        while (mQueue.isEmpty() && !mStopRequested)
+        {
+            mWritesQueued.wait(&mMutex);
+        }
+        if (mQueue.isEmpty())
+        {
+            break;
+        }
+
+        // writes which come shortly after the first one are committed with it,
+        // unless reader waits for them
+        QElapsedTimer batchTimer;
+        batchTimer.start();
+        while (mQueue.size() < DB_WRITES_BATCH_SIZE && !mStopRequested && !mKeyWaitersCount
+               && batchTimer.elapsed() < DB_WRITES_BATCH_DELAY)
+        {
+            mWritesQueued.wait(&mMutex, static_cast<unsigned long>(DB_WRITES_BATCH_DELAY - batchTimer.elapsed()));
+        }
+
+        const int batchSize = qMin(mQueue.size(), DB_WRITES_BATCH_SIZE);
+        const QVector<Write> batch = mQueue.mid(0, batchSize);
+        mQueue.remove(0, batchSize);
+        mBatchInProgress = true;
+        locker.unlock();
+
+        pConnection->openDatabase();
+        commitBatch(*pConnection, batch);
+
+        locker.relock();
+        mBatchInProgress = false;
+        mLastCommittedNumber = batch.last().mNumber;
+        for (auto keyIter = mLastWriteByKey.begin(); keyIter != mLastWriteByKey.end();)
+        {
+            if (keyIter.value() <= mLastCommittedNumber)
+            {
+                keyIter = mLastWriteByKey.erase(keyIter);
+            }
+            else
+            {
+                ++keyIter;
+            }
+        }
+        mWritesCommitted.wakeAll();
+    }
+    locker.unlock();
+
+    ConnectionGetter::closeThreadConnections();
+}
+
+void DbWriter::commitBatch(Connection &connection, const QVector<Write> &batch)
+{
+    QSqlDatabase db = connection.getDatabase();
+    const bool transactionStarted = db.isOpen() && db.transaction();
+    QVector<bool> results;
+    for (const auto &write : batch)
+    {
+        bool success = db.isOpen() && QSqlQuery(db).exec(writeSavepointQuery);
+        const bool savepointSet = success;
+        for (const auto &statement : write.mStatements)
+        {
+            if (!success)
+            {
+                break;
+            }
+
+            // statements of every shape are prepared once per connection
+            QSqlQuery &query = connection.getPreparedQuery(statement.mQuery);
+            for (int i = 0; i < statement.mValues.size(); ++i)
+            {
+                query.bindValue(i, statement.mValues[i]);
+            }
+            success = query.exec();
+            query.finish();
+        }
+        if (!success)
+        {
+            qDebug()<<"not executed query";
+        }
+        // statements of failed write executed before its failure are undone,
+        // so its result matches what is committed
+        if (savepointSet)
+        {
+            if (!success)
+            {
+                QSqlQuery(db).exec(rollbackWriteQuery);
+            }
+            // release commits write when batch transaction couldn't be started
+            success = QSqlQuery(db).exec(releaseWriteQuery) && success;
+        }
+        results.push_back(success);
+    }
+
+    const bool committed = !transactionStarted || db.commit();
+    if (!committed)
+    {
+        qDebug()<<"not committed transaction";
+        db.rollback();
+    }
+    for (int i = 0; i < batch.size(); ++i)
+    {
+        batch[i].mpResult->set_value(committed && results[i]);
+    }
+}
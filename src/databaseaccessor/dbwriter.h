@@ -0,0 +1,73 @@
+#ifndef DBWRITER_H
+#define DBWRITER_H
+#include <QWaitCondition>
+#include <QStringList>
+#include <QVariant>
+#include <QThread>
+#include <QVector>
+#include <QMutex>
+#include <QHash>
+#include <future>
+#include <memory>
+
+// writes are committed in one transaction when this many of them are queued
+// or when the first of them has waited this long
+const int DB_WRITES_BATCH_SIZE = 256;
+const int DB_WRITES_BATCH_DELAY = 50;
+
+class Connection;
+
+// thread which performs writes of accessors on its connection from ConnectionGetter,
+// so gui thread only queues them & doesn't wait for SQLite
+class DbWriter: public QThread
+{
+public:
+    struct Statement
+    {
+        QString mQuery;
+        QVariantList mValues;
+    };
+
+    static DbWriter* getDefaultWriter();
+    ~DbWriter();
+
+    // statements are executed in the order of requests, all statements of one write
+    // are committed in the same transaction, future reports whether all of them succeeded,
+    // keys name data which is changed by write (e.g. comments of file)
+    std::future<bool> write(const QVector<Statement> &statements, const QStringList &keys = QStringList());
+    // blocks until the last write with key is committed, so data is read with its own changes,
+    // writer doesn't wait for more writes to batch meanwhile, returns at once if there is no such write
+    void waitForKey(const QString &key);
+    // blocks until every queued write is committed (e.g. before another database is opened)
+    void waitForDone();
+
+protected:
+    void run() override;
+
+private:
+    DbWriter();
+
+    struct Write
+    {
+        QVector<Statement> mStatements;
+        std::shared_ptr<std::promise<bool>> mpResult;
+        quint64 mNumber;
+    };
+
+    void commitBatch(Connection &connection, const QVector<Write> &batch);
+
+    // accessed from both threads under mutex
+    QMutex mMutex;
+    QWaitCondition mWritesQueued;
+    QWaitCondition mWritesCommitted;
+    QVector<Write> mQueue;
+    // writes are numbered in the order of requests, so committed ones are told by number
+    quint64 mLastQueuedNumber;
+    quint64 mLastCommittedNumber;
+    QHash<QString, quint64> mLastWriteByKey;
+    int mKeyWaitersCount;
+    bool mBatchInProgress;
+    bool mStopRequested;
+};
+
+#endif // DBWRITER_H
@@ -1,51 +1,215 @@
 #include "filedb.h"
+#include "dbidcache.h"
+#include "dbwriter.h"
+#include "fileidentity.h"
+#include <QThreadPool>
+#include <QRunnable>
+#include <QFileInfo>
+#include <functional>
 
-FileDb::FileDb(): Accessor ()
+namespace
+{
+
+// identity of files is read & compared on worker, so gui thread doesn't hash their content
+class FileIdentityTask: public QRunnable
+{
+public:
+    explicit FileIdentityTask(const std::function<void()> &work):
+        mWork(work)
+    {
+    }
+
+    void run() override
+    {
+        mWork();
+    }
+
+private:
+    std::function<void()> mWork;
+};
+
+QThreadPool& getIdentityPool()
+{
+    // writer is created first, so it's destroyed after pool finished tasks which use it
+    DbWriter::getDefaultWriter();
+    // single thread keeps order of tasks, its connections are closed when it expires
+    static QThreadPool identityPool;
+    identityPool.setMaxThreadCount(1);
+    return identityPool;
+}
+
+}
+
+FileDb::FileDb(ConnectionMode mode): Accessor (mode)
 {
 }
 
 FileDb::~FileDb()
 {
-    query.finish();
 }
 
 void FileDb::addFileToDb(const File &file)
 {
-    execQuery(addFileQuery(file));
-    query.finish();
+    const QString key = file.mKey.isEmpty() ? FileIdentity::getFileKey(file.mName) : file.mKey;
+    const QString fingerprint = file.mFingerprint.isEmpty() ? FileIdentity::getFingerprint(file.mName)
+                                                            : file.mFingerprint;
+    execQuery(addFileQuery(), {file.mName, key.isEmpty() ? QVariant() : key,
+                               fingerprint.isEmpty() ? QVariant() : fingerprint}).finish();
 }
 
 File FileDb::getFileFromDb(const int idFile)
 {
-    execQuery(getFileQuery(idFile));
+    QSqlQuery &query = execQuery(getFileQuery(), {idFile});
     File rFile;
-    fillStructureFile(rFile);
+    if (query.first())
+    {
+        fillStructureFile(query, rFile);
+    }
+    query.finish();
     return rFile;
 }
 
+int FileDb::getFileIdFromDb(const QString &filename)
+{
+    QSqlQuery &query = execQuery(getFileIdQuery(), {filename});
+    const int rId = query.first() ? query.value(0).toInt() : 0;
+    query.finish();
+    return rId;
+}
+
+int FileDb::resolveFileIdFromDb(const QString &filename)
+{
+    const int rId = getFileIdFromDb(filename);
+    if (rId)
+    {
+        return rId;
+    }
+
+    // file system is asked only for files which aren't known by name,
+    // empty files have the same content, so they aren't matched
+    const QString key = FileIdentity::getFileKey(filename);
+    if (key.isEmpty() || QFileInfo(filename).size() == 0)
+    {
+        return 0;
+    }
+    return findMovedFileId(filename, key);
+}
+
+void FileDb::detectMovedFilesAsync(const QStringList &filenames)
+{
+    getIdentityPool().start(new FileIdentityTask([filenames]()
+    {
+        FileDb fileDb(ConnectionMode::ReadOnly);
+        for (const auto &filename : filenames)
+        {
+            fileDb.resolveFileIdFromDb(filename);
+        }
+    }));
+}
+
+void FileDb::updateFileIdentityInDb(const QString &filename)
+{
+    const QString key = FileIdentity::getFileKey(filename);
+    if (key.isEmpty())
+    {
+        return;
+    }
+    DbWriter::getDefaultWriter()->write({DbWriter::Statement {updateFileIdentityQuery(),
+                                                              {key, FileIdentity::getFingerprint(filename), filename}}});
+}
+
+void FileDb::updateFileIdentityAsync(const QString &filename)
+{
+    getIdentityPool().start(new FileIdentityTask([filename]()
+    {
+        FileDb(ConnectionMode::ReadOnly).updateFileIdentityInDb(filename);
+    }));
+}
+
+int FileDb::findMovedFileId(const QString &filename, const QString &key)
+{
+    QSqlQuery &query = execQuery(getFilesByKeyQuery(), {key});
+    QVector<File> candidates;
+    while (query.next())
+    {
+        File file;
+        fillStructureFileIdentity(query, file);
+        candidates.push_back(file);
+    }
+    query.finish();
+
+    // file system reuses keys of deleted files, so content of file which could be moved is compared too
+    QString fingerprint;
+    for (const auto &candidate : candidates)
+    {
+        if (QFileInfo::exists(candidate.mName))
+        {
+            continue;
+        }
+        if (fingerprint.isEmpty())
+        {
+            fingerprint = FileIdentity::getFingerprint(filename);
+        }
+        if (!fingerprint.isEmpty() && candidate.mFingerprint == fingerprint)
+        {
+            DbWriter::getDefaultWriter()->write({DbWriter::Statement {updateFileQuery(),
+                                                                      {filename, key, fingerprint, candidate.mId}}});
+            return candidate.mId;
+        }
+    }
+    return 0;
+}
+
 void FileDb::deleteFileFromDb(const QString filename)
 {
-    execQuery(deleteFileQuery(filename));
+    execQuery(deleteFileQuery(), {filename}).finish();
+    DbIdCache::getDefaultCache().forgetFile(filename);
+}
+
+QString FileDb::addFileQuery()
+{
+    return "INSERT INTO File (name, fileKey, fingerprint) VALUES (?, ?, ?)";
+}
+
+QString FileDb::getFileQuery()
+{
+    return "SELECT name from File WHERE ID = ?";
+}
+
+QString FileDb::getFileIdQuery()
+{
+    return "SELECT id FROM File WHERE name = ?";
+}
+
+QString FileDb::getFilesByKeyQuery()
+{
+    return "SELECT name, id, fileKey, fingerprint FROM File WHERE fileKey = ?";
+}
+
+QString FileDb::updateFileQuery()
+{
+    return "UPDATE File SET name = ?, fileKey = ?, fingerprint = ? WHERE id = ?";
 }
 
-QString FileDb::addFileQuery(const File &file)
+QString FileDb::updateFileIdentityQuery()
 {
-    return "INSERT INTO File (name) VALUES ('"
-            +file.mName + "')";
+    return "UPDATE File SET fileKey = ?, fingerprint = ? WHERE name = ?";
 }
 
-QString FileDb::getFileQuery(const int idFile)
+QString FileDb::deleteFileQuery()
 {
-    return "SELECT name from File WHERE ID = "
-            + QString::number(idFile);
+    return "DELETE FROM File WHERE name = ?";
 }
 
-QString FileDb::deleteFileQuery(const QString filename)
+void FileDb::fillStructureFile(const QSqlQuery &query, File &file)
 {
-    return "DELETE FROM User WHERE name = '" + filename + "'";
+    file.mName = query.value(0).toString();
 }
 
-void FileDb::fillStructureFile(File &file)
+void FileDb::fillStructureFileIdentity(const QSqlQuery &query, File &file)
 {
-    file.mName = query.record().value(0).toString();
+    fillStructureFile(query, file);
+    file.mId = query.value(1).toInt();
+    file.mKey = query.value(2).toString();
+    file.mFingerprint = query.value(3).toString();
 }
@@ -2,20 +2,43 @@
 #define FILEDB_H
 #include "accessor.h"
 #include "structsfordb.h"
+#include <QStringList>
 
 class FileDb : public Accessor
 {
 public:
-    FileDb();
+    explicit FileDb(ConnectionMode mode = ConnectionMode::ReadWrite);
     ~FileDb();
     void addFileToDb(const File &file);
     File getFileFromDb(const int idFile);
+    // 0 is returned if there is no such file
+    int getFileIdFromDb(const QString &filename);
+    // file which isn't found by name, but has key & content of file whose name doesn't exist anymore,
+    // was renamed or moved, so that row gets its new name & keeps its comments,
+    // content is read only when there is such key, 0 is returned if there is no such file,
+    // updates are queued to writer, so ids resolved by them are bound by writes queued after them
+    int resolveFileIdFromDb(const QString &filename);
+    // files which appeared in project (e.g. were renamed or moved) get rows of missing files
+    // on identity worker, so their comments are found by name when they're opened
+    void detectMovedFilesAsync(const QStringList &filenames);
+    // file was written (e.g. replaced on save), so its new key & content become its identity
+    void updateFileIdentityInDb(const QString &filename);
+    // content is hashed on identity worker, updates of the same file are queued in order
+    void updateFileIdentityAsync(const QString &filename);
     void deleteFileFromDb(const  QString filename);
 private:
-    QString addFileQuery(const File &file);
-    QString getFileQuery(const int idFile);
-    QString deleteFileQuery(const QString filename);
-    void fillStructureFile(File &file);
+    QString addFileQuery();
+    QString getFileQuery();
+    QString getFileIdQuery();
+    QString getFilesByKeyQuery();
+    QString updateFileQuery();
+    QString updateFileIdentityQuery();
+    QString deleteFileQuery();
+    void fillStructureFile(const QSqlQuery &query, File &file);
+    void fillStructureFileIdentity(const QSqlQuery &query, File &file);
+    // id of file with the same key & content whose name doesn't exist anymore (not of its copy),
+    // its row gets new name
+    int findMovedFileId(const QString &filename, const QString &key);
 
 };
 
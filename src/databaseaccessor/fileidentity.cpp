@@ -0,0 +1,51 @@
+#include "fileidentity.h"
+#include <QCryptographicHash>
+#include <QFile>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+QString FileIdentity::getFileKey(const QString &fileName)
+{
+#ifdef Q_OS_WIN
+    HANDLE handle = CreateFileW(reinterpret_cast<const wchar_t*>(fileName.utf16()), 0,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        return QString();
+    }
+    BY_HANDLE_FILE_INFORMATION info;
+    const bool infoRead = GetFileInformationByHandle(handle, &info);
+    CloseHandle(handle);
+    if (!infoRead)
+    {
+        return QString();
+    }
+    const quint64 fileIndex = (static_cast<quint64>(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+    return QString("%1:%2").arg(info.dwVolumeSerialNumber).arg(fileIndex);
+#else
+    struct stat fileStat;
+    if (stat(QFile::encodeName(fileName).constData(), &fileStat) != 0)
+    {
+        return QString();
+    }
+    return QString("%1:%2").arg(static_cast<quint64>(fileStat.st_dev))
+                           .arg(static_cast<quint64>(fileStat.st_ino));
+#endif
+}
+
+QString FileIdentity::getFingerprint(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return QString();
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(&file);
+    return QString::fromLatin1(hash.result().toHex());
+}
@@ -0,0 +1,18 @@
+#ifndef FILEIDENTITY_H
+#define FILEIDENTITY_H
+#include <QString>
+
+// identity of file on disk which is kept when file is renamed or moved:
+// key of file system object (device & inode, volume & file index on Windows)
+// & fingerprint of content, both of them are compared, so new file which reuses key
+// of deleted one or copy of its content isn't taken for it
+class FileIdentity
+{
+    FileIdentity() = default;
+public:
+    // empty string is returned if there is no such file
+    static QString getFileKey(const QString &fileName);
+    static QString getFingerprint(const QString &fileName);
+};
+
+#endif // FILEIDENTITY_H
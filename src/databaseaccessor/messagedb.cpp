@@ -1,64 +1,136 @@
 #include "messagedb.h"
+#include <algorithm>
+#include "dbidcache.h"
 
-MessageDb::MessageDb(): Accessor()
+MessageDb::MessageDb(ConnectionMode mode): Accessor(mode)
 {
 }
 
 MessageDb::~MessageDb()
 {
-    query.finish();
 }
 
 void MessageDb::addMessageToDb(const Message &message)
 {
-    execQuery(addMessageQuery(message));
+    execQuery(addMessageQuery(), {DbIdCache::getDefaultCache().getUserId(message.mUser),
+                                  message.mBody, message.mTime}).finish();
+}
+
+std::future<bool> MessageDb::addMessageToDbAsync(const Message &message)
+{
+    return DbWriter::getDefaultWriter()->write({DbWriter::Statement {addMessageQuery(),
+                                                                     {DbIdCache::getDefaultCache().getUserId(message.mUser),
+                                                                      message.mBody, message.mTime}}},
+                                               {messagesWriteKey()});
 }
 
 QVector<Message> MessageDb::getMessageFromDb(const QString startTime)
 {
-    execQuery(numberOfMessages(startTime));
+    // messages which are being written by writer thread are read too
+    DbWriter::getDefaultWriter()->waitForKey(messagesWriteKey());
+    QVector<Message> messages;
+    QSqlQuery &query = execQuery(getMessageQuery(), {startTime});
+    while (query.next())
+    {
+        Message message;
+        fillStructMessage(query, message);
+        messages.push_back(message);
+    }
+    query.finish();
+    return messages;
+}
+
+QVector<Message> MessageDb::getMessagesPageFromDb(const QString &beforeTime, const int beforeId, const int pageSize)
+{
+    // queued messages are newer than displayed ones, so only the newest page waits for them
+    if (beforeTime.isEmpty())
+    {
+        DbWriter::getDefaultWriter()->waitForKey(messagesWriteKey());
+    }
+    QVector<Message> messages;
+    QSqlQuery &query = beforeTime.isEmpty()
+            ? execQuery(newestMessagesPageQuery(), {pageSize})
+            : execQuery(olderMessagesPageQuery(), {beforeTime, beforeTime, beforeId, pageSize});
+    while (query.next())
+    {
+        Message message;
+        fillStructMessage(query, message);
+        messages.push_back(message);
+    }
+    query.finish();
+
+    // page is read from the newest message
+    std::reverse(messages.begin(), messages.end());
+    return messages;
+}
+
+QVector<Message> MessageDb::searchMessagesInDb(const QString &text, const int offset, const int pageSize)
+{
+    QVector<Message> messages;
+    const QString fullTextQuery = toFullTextQuery(text);
+    if (fullTextQuery.isEmpty())
+    {
+        return messages;
+    }
 
-    query.first();
-    int countOfMessages =query.value(0).toInt();
-    if (!countOfMessages)
+    // committed messages are searched, reader doesn't wait for writer
+    QSqlQuery &query = execQuery(searchMessagesQuery(), {fullTextQuery, pageSize, offset});
+    while (query.next())
     {
-        return QVector<Message>();
+        Message message;
+        fillStructMessage(query, message);
+        messages.push_back(message);
     }
-    QVector<Message> messages(countOfMessages);
-    execQuery(getMessageQuery(startTime));
-    query.first();
-    int counter = 0;
-    do {
-        fillStructMessage(messages[counter]);
-        counter++;
-    } while (query.next());
+    query.finish();
     return messages;
 }
 
-QString MessageDb::addMessageQuery(const Message &message)
+QString MessageDb::addMessageQuery()
 {
-    return "INSERT INTO Message (idUser, messageText, time) VALUES ("
-            "(Select id from User where nickname = '" + message.mUser + "'), '"
-            + message.mBody + "', '" + message.mTime + "')";
+    return "INSERT INTO Message (idUser, messageText, time) VALUES (?, ?, ?)";
 }
 
-QString MessageDb::getMessageQuery(const QString startTime)
+QString MessageDb::getMessageQuery()
 {
-    return "Select Message.messageText, User.nickname, datetime(Message.time)"
+    // time is kept as 'YYYY-MM-DD hh:mm:ss', so it's compared as is & range is read by index
+    return "Select Message.messageText, User.nickname, datetime(Message.time), Message.id"
            " from Message inner join User on Message.idUser = User.id"
-           " where date(Message.time) >= '" + startTime +"'";
+           " where Message.time >= ? order by Message.time, Message.id";
 }
 
-QString MessageDb::numberOfMessages(const QString startTime)
+QString MessageDb::newestMessagesPageQuery()
 {
-    return "Select count(Message.messageText)"
+    return "Select Message.messageText, User.nickname, Message.time, Message.id"
            " from Message inner join User on Message.idUser = User.id"
-           " where datetime(Message.time) >= '" + startTime +"'";
+           " order by Message.time desc, Message.id desc limit ?";
+}
+
+QString MessageDb::searchMessagesQuery()
+{
+    return "Select Message.messageText, User.nickname, Message.time, Message.id"
+           " from MessageSearch inner join Message on Message.id = MessageSearch.rowid"
+           " inner join User on Message.idUser = User.id"
+           " where MessageSearch match ? order by MessageSearch.rank limit ? offset ?";
+}
+
+QString MessageDb::olderMessagesPageQuery()
+{
+    // time bounds range of index, id orders messages written in the same second
+    return "Select Message.messageText, User.nickname, Message.time, Message.id"
+           " from Message inner join User on Message.idUser = User.id"
+           " where Message.time <= ? and (Message.time < ? or Message.id < ?)"
+           " order by Message.time desc, Message.id desc limit ?";
+}
+
+void MessageDb::fillStructMessage(const QSqlQuery &query, Message &message)
+{
+    message.mBody = query.value(0).toString();
+    message.mUser = query.value(1).toString();
+    message.mTime = query.value(2).toString();
+    message.mId = query.value(3).toInt();
 }
 
-void MessageDb::fillStructMessage(Message &message)
+QString MessageDb::messagesWriteKey()
 {
-    message.mBody = query.record().value(0).toString();
-    message.mUser = query.record().value(1).toString();
-    message.mTime = query.record().value(2).toString();
+    return "messages";
 }
@@ -2,19 +2,31 @@
 #define MESSAGEDB_H
 #include "accessor.h"
 #include "structsfordb.h"
+#include "dbwriter.h"
 
 class MessageDb : public Accessor
 {
 public:
-    MessageDb();
+    explicit MessageDb(ConnectionMode mode = ConnectionMode::ReadWrite);
     ~MessageDb();
     void addMessageToDb(const Message& message);
+    // message is committed by writer thread
+    std::future<bool> addMessageToDbAsync(const Message& message);
     QVector <Message> getMessageFromDb(const QString startTime);
+    // page of messages written before the message with given time & id (the newest page if time is empty),
+    // pages are read by keyset on (time, id), so every page is one index range scan
+    QVector <Message> getMessagesPageFromDb(const QString &beforeTime, const int beforeId, const int pageSize);
+    // messages which contain words of text, the most relevant first
+    QVector <Message> searchMessagesInDb(const QString &text, const int offset, const int pageSize);
 private:
-    QString addMessageQuery(const Message& message);
-    QString getMessageQuery(const QString startTime);
-    QString numberOfMessages(const QString startTime);
-    void fillStructMessage(Message &message);
+    QString addMessageQuery();
+    QString getMessageQuery();
+    QString newestMessagesPageQuery();
+    QString olderMessagesPageQuery();
+    QString searchMessagesQuery();
+    // key of writes which add messages
+    QString messagesWriteKey();
+    void fillStructMessage(const QSqlQuery &query, Message &message);
 };
 
 #endif // MESSAGEDB_H
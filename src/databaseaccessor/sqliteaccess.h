@@ -7,5 +7,7 @@
 #include "messagedb.h"
 #include "structsfordb.h"
 #include "createdb.h"
+#include "dbwriter.h"
+#include "dbidcache.h"
 
 #endif // SQLITEACCESS_H
@@ -16,6 +16,7 @@ struct Message
     QString mBody;
     QString mUser;
     QString mTime;  //YYYY-MM-DD hh:mm:ss
+    int mId = 0;    // is set for messages read from DB
 };
 
 struct User
@@ -27,6 +28,7 @@ struct User
     }
 
     QString mNickname;
+    int mId = 0;    // is set for users read from DB
 };
 
 struct File
@@ -38,6 +40,9 @@ struct File
     }
 
     QString mName;
+    int mId = 0;    // is set for files read from DB
+    QString mKey;           // identity of file, which is kept when it's renamed or moved
+    QString mFingerprint;   // (see FileIdentity)
 };
 
 struct Comment
@@ -5,54 +5,69 @@ UserDb::UserDb(): Accessor()
 
 UserDb::~UserDb()
 {
-    query.finish();
 }
 
 void UserDb::addUserToDb(const User &user)
 {
-    execQuery(addUserQuery(user));
+    execQuery(addUserQuery(), {user.mNickname}).finish();
 }
 
 User UserDb::getUserFromDb(const int idUser)
 {
-    execQuery(getUserQuery(idUser));
-    query.first();
+    QSqlQuery &query = execQuery(getUserQuery(), {idUser});
     User rUser;
-    fillStructUser(rUser);
+    if (query.first())
+    {
+        fillStructUser(query, rUser);
+    }
+    query.finish();
     return rUser;
 }
 
+int UserDb::getUserIdFromDb(const QString &nickname)
+{
+    QSqlQuery &query = execQuery(getUserIdQuery(), {nickname});
+    const int rId = query.first() ? query.value(0).toInt() : 0;
+    query.finish();
+    return rId;
+}
+
 QVector<User> UserDb::getAllUsersFromDb()
 {
-    execQuery(numberOfUser());
-    query.first();
-    int count = query.record().value(0).toInt();
+    QSqlQuery &query = execQuery(allUsersQuery());
     QVector<User> rUser;
-    for (int i = 0; i < count; i++)
+    while (query.next())
     {
-        rUser.push_back(getUserFromDb(i));
+        User user;
+        fillStructUser(query, user);
+        user.mId = query.value(1).toInt();
+        rUser.push_back(user);
     }
+    query.finish();
     return rUser;
 }
 
-QString UserDb::addUserQuery(const User &user)
+QString UserDb::addUserQuery()
+{
+    return "INSERT INTO User (nickname) VALUES (?)";
+}
+
+QString UserDb::getUserQuery()
 {
-    return "INSERT INTO User (nickname) VALUES ('"
-            +user.mNickname +"')";
+    return "SELECT nickname FROM User WHERE id = ?";
 }
 
-QString UserDb::getUserQuery(const int idUser)
+QString UserDb::getUserIdQuery()
 {
-    return "SELECT nickname FROM User WHERE id = "
-            +QString::number(idUser);
+    return "SELECT id FROM User WHERE nickname = ?";
 }
 
-void UserDb::fillStructUser(User &user)
+QString UserDb::allUsersQuery()
 {
-    user.mNickname = query.record().value(0).toString();
+    return "SELECT nickname, id FROM User ORDER BY id";
 }
 
-QString UserDb::numberOfUser()
+void UserDb::fillStructUser(const QSqlQuery &query, User &user)
 {
-    return "Select count(user.id) from User";
+    user.mNickname = query.value(0).toString();
 }
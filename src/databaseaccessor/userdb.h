@@ -9,12 +9,16 @@ public:
     ~UserDb();
     void addUserToDb(const User &user);
     User getUserFromDb(const int idUser);
+    // 0 is returned if there is no such user
+    int getUserIdFromDb(const QString &nickname);
+    // all users with their ids are read by one query
     QVector<User> getAllUsersFromDb();
 private:
-    QString addUserQuery(const User &user);
-    QString getUserQuery(const int idUser);
-    void fillStructUser(User &user);
-    QString numberOfUser();
+    QString addUserQuery();
+    QString getUserQuery();
+    QString getUserIdQuery();
+    QString allUsersQuery();
+    void fillStructUser(const QSqlQuery &query, User &user);
 };
 
 #endif // USERDB_H
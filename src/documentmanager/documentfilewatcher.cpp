@@ -0,0 +1,69 @@
+#include "documentfilewatcher.h"
+
+#include <QFileInfo>
+
+DocumentFileWatcher::DocumentFileWatcher(QObject *pParent):
+    QObject(pParent)
+{
+    mBatchTimer.setSingleShot(true);
+    mBatchTimer.setInterval(FILE_CHANGES_BATCH_DELAY);
+    connect(&mWatcher, &QFileSystemWatcher::fileChanged, this, &DocumentFileWatcher::onFileChanged);
+    connect(&mBatchTimer, &QTimer::timeout, this, &DocumentFileWatcher::reportChanges);
+}
+
+void DocumentFileWatcher::watch(const QString &fileName)
+{
+    // removed file isn't watched by system anymore, so it's added again when it's written
+    mWatchedFiles.insert(fileName);
+    if (QFileInfo::exists(fileName) && !mWatcher.files().contains(fileName))
+    {
+        mWatcher.addPath(fileName);
+    }
+}
+
+void DocumentFileWatcher::unwatch(const QString &fileName)
+{
+    if (mWatchedFiles.remove(fileName))
+    {
+        mWatcher.removePath(fileName);
+    }
+    mChangedFiles.remove(fileName);
+}
+
+void DocumentFileWatcher::clear()
+{
+    if (!mWatcher.files().isEmpty())
+    {
+        mWatcher.removePaths(mWatcher.files());
+    }
+    mWatchedFiles.clear();
+    mChangedFiles.clear();
+    mBatchTimer.stop();
+}
+
+void DocumentFileWatcher::onFileChanged(const QString &fileName)
+{
+    mChangedFiles.insert(fileName);
+    // batch is reported after delay since its first change, so constant changes don't delay it forever
+    if (!mBatchTimer.isActive())
+    {
+        mBatchTimer.start();
+    }
+}
+
+void DocumentFileWatcher::reportChanges()
+{
+    const QStringList changedFiles = mChangedFiles.toList();
+    mChangedFiles.clear();
+
+    // file which is replaced (e.g. by atomic save) isn't watched anymore, so it's added again
+    const QSet<QString> watcherFiles = mWatcher.files().toSet();
+    for (const auto &fileName : changedFiles)
+    {
+        if (mWatchedFiles.contains(fileName) && !watcherFiles.contains(fileName) && QFileInfo::exists(fileName))
+        {
+            mWatcher.addPath(fileName);
+        }
+    }
+    emit filesChanged(changedFiles);
+}
@@ -0,0 +1,41 @@
+#ifndef DOCUMENTFILEWATCHER_H
+#define DOCUMENTFILEWATCHER_H
+
+#include <QFileSystemWatcher>
+#include <QStringList>
+#include <QObject>
+#include <QTimer>
+#include <QSet>
+
+// changes which come during this time are reported together
+// (e.g. when branch is switched every opened file is changed)
+const int FILE_CHANGES_BATCH_DELAY = 300;
+
+// watches files of opened docs & reports their changes in batches
+class DocumentFileWatcher: public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DocumentFileWatcher(QObject *pParent = nullptr);
+
+    // file which is already watched is added to system watcher again if it was dropped (e.g. removed)
+    void watch(const QString &fileName);
+    void unwatch(const QString &fileName);
+    void clear();
+
+signals:
+    void filesChanged(const QStringList &fileNames);
+
+private slots:
+    void onFileChanged(const QString &fileName);
+    void reportChanges();
+
+private:
+    QFileSystemWatcher mWatcher;
+    QSet<QString> mWatchedFiles;
+    QSet<QString> mChangedFiles;
+    QTimer mBatchTimer;
+};
+
+#endif // DOCUMENTFILEWATCHER_H
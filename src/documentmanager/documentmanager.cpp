@@ -1,22 +1,62 @@
 #include "documentmanager.h"
 
+#include <QCryptographicHash>
+#include <QStandardPaths>
 #include <QMdiSubWindow>
-#include <QDirIterator>
 #include <QMessageBox>
 #include <QSplitter>
 #include <algorithm>
+#include <memory>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QSettings>
+#include <QFileInfo>
 #include <QMdiArea>
 #include <QVector>
 #include <QDebug>
 #include <QDir>
 
+#include "documentfilewatcher.h"
+#include "tabmemorymanager.h"
+#include "recoveryjournal.h"
+#include "projectfileindex.h"
+#include "asyncfileloader.h"
+#include "asyncfilesaver.h"
 #include "usermessages.h"
 #include "filemanager.h"
 #include "codeeditor.h"
+#include "dbidcache.h"
+#include "filedb.h"
 #include "utils.h"
 
-DocumentManager::DocumentManager()
+const char *sessionsDirName = "sessions";
+const char *sessionFileSuffix = ".json";
+
+DocumentManager::DocumentManager():
+    mpPrevEditorInFocus(nullptr),
+    mRestoringSession(false)
 {
+    mpProjectFileIndex = new ProjectFileIndex(this);
+    // renamed & moved files get rows of their previous names before they're opened
+    connect(mpProjectFileIndex, &ProjectFileIndex::filesAdded, this, [](const QStringList &fileNames)
+    {
+        FileDb().detectMovedFilesAsync(fileNames);
+    });
+    mpFileSaver = new AsyncFileSaver(this);
+    mFailedSavesCount = 0;
+    connect(mpFileSaver, &AsyncFileSaver::saveFinished, this, &DocumentManager::onSaveFinished);
+
+    mpFileWatcher = new DocumentFileWatcher(this);
+    connect(mpFileWatcher, &DocumentFileWatcher::filesChanged, this, &DocumentManager::onFilesChanged);
+
+    mpRecoveryJournal = new RecoveryJournal(this);
+
+    mpTabMemoryManager = new TabMemoryManager(this);
+    QSettings settings;
+    mpTabMemoryManager->setMemoryBudget(settings.value("tabsMemoryBudgetMb", DEFAULT_TABS_MEMORY_BUDGET_MB)
+                                        .toLongLong() * 1024 * 1024);
+
     mpSplitter = new QSplitter;
     mpSplitter->setChildrenCollapsible(false);
 
@@ -41,6 +81,7 @@ QSplitter* DocumentManager::getSplitter()
 void DocumentManager::openProject(const QString &path)
 {
     currentProject = path;
+    mpProjectFileIndex->setRootPath(path);
 }
 
 const QString& DocumentManager::getCurrentProjectPath() const
@@ -51,163 +92,408 @@ const QString& DocumentManager::getCurrentProjectPath() const
 void DocumentManager::closeCurrentProject()
 {
     currentProject.clear();
+    mpProjectFileIndex->clear();
 }
 
-void DocumentManager::openDocument(const QString &fileName, bool load)
+ProjectFileIndex* DocumentManager::getProjectFileIndex()
 {
-    // checks if doc is not already opened
-    auto pOpenedDoc = openedDoc(fileName);
-    // if doc is already opened - it becomes active
-    if (pOpenedDoc)
+    return mpProjectFileIndex;
+}
+
+void DocumentManager::saveSession()
+{
+    if (!projectOpened())
+    {
+        return;
+    }
+
+    QDir projectDir(currentProject);
+    QJsonArray areas;
+    int activeArea = 0;
+    for (const auto &area : mDocAreas)
     {
-        for (auto &area: mDocAreas)
+        QJsonArray docs;
+        int currentDoc = -1;
+        for (const auto &wdw : area->subWindowList())
         {
-            if (area->subWindowList().contains(pOpenedDoc))
+            auto doc = qobject_cast<CodeEditor*>(wdw->widget());
+            if (!doc)
+            {
+                continue;
+            }
+            if (wdw == area->currentSubWindow())
             {
-                area->setActiveSubWindow(pOpenedDoc);
-                return;
+                currentDoc = docs.size();
             }
+            if (doc == mpPrevEditorInFocus)
+            {
+                activeArea = areas.size();
+            }
+
+            const ViewPosition position = doc->getViewPosition();
+            QJsonObject docObject;
+            docObject["file"] = projectDir.relativeFilePath(doc->getFileName());
+            docObject["cursor"] = position.mCursorPosition;
+            docObject["verticalScroll"] = position.mVerticalScroll;
+            docObject["horizontalScroll"] = position.mHorizontalScroll;
+            docs.append(docObject);
         }
+
+        QJsonObject areaObject;
+        areaObject["docs"] = docs;
+        areaObject["current"] = currentDoc;
+        areas.append(areaObject);
     }
 
-    // create new view
-    CodeEditor *newView = createDoc(fileName);
+    QJsonObject session;
+    session["orientation"] = static_cast<int>(mpSplitter->orientation());
+    session["activeArea"] = activeArea;
+    session["areas"] = areas;
 
-    // select doc area to accomodate new doc
-    auto placementArea = selectAreaForPlacement();
+    // session is not essential, so project is closed even if it can't be written
+    const QString sessionFile = getSessionFileName();
+    if (!QDir().mkpath(QFileInfo(sessionFile).path()))
+    {
+        qDebug() << "session of project is not saved";
+        return;
+    }
+    try
+    {
+        FileManager().writeToFile(sessionFile,
+                                  QString::fromUtf8(QJsonDocument(session).toJson()));
+    }
+    catch (const FileOpeningFailure&)
+    {
+        qDebug() << "session of project is not saved";
+    }
+}
 
-    if (!placementArea)
+void DocumentManager::restoreSession()
+{
+    QDir projectDir(currentProject);
+    const QString sessionFile = getSessionFileName();
+    if (!projectOpened() || !QFileInfo::exists(sessionFile))
     {
-        throw DocumentPlacementFailure();
+        return;
     }
 
-    // doc is added to doc area & unfolded
-    placementArea->addSubWindow(newView);
-    newView->setWindowState(Qt::WindowMaximized);
+    QJsonObject session;
+    try
+    {
+        session = QJsonDocument::fromJson(FileManager().readFromFile(sessionFile).toUtf8()).object();
+    }
+    catch (const FileOpeningFailure&)
+    {
+        return;
+    }
 
-    // if necessary - doc content is read from file & placed in doc
-    if (load)
+    const QJsonArray areas = session["areas"].toArray();
+    if (areas.isEmpty())
     {
-        try
+        return;
+    }
+    mpSplitter->setOrientation(session["orientation"].toInt() == Qt::Vertical ? Qt::Vertical : Qt::Horizontal);
+
+    // every tab is placeholder which reads its file when it's activated
+    mRestoringSession = true;
+    for (int i = 0; i < areas.size(); ++i)
+    {
+        if (i >= mDocAreas.size())
         {
-            loadFile(newView, fileName);
-        } catch (const FileOpeningFailure&)
+            splitWindow();
+        }
+        QMdiArea *pArea = mDocAreas[i];
+        const QJsonObject areaObject = areas[i].toObject();
+        const QJsonArray docs = areaObject["docs"].toArray();
+        QMdiSubWindow *pCurrentWdw = nullptr;
+
+        for (int j = 0; j < docs.size(); ++j)
         {
-            throw;
+            const QJsonObject docObject = docs[j].toObject();
+            const QString fileName = QDir::cleanPath(projectDir.absoluteFilePath(docObject["file"].toString()));
+            if (!QFileInfo(fileName).isFile() || mDocRegistry.findByPath(fileName))
+            {
+                continue;
+            }
+
+            CodeEditor *doc = createDoc(fileName);
+            doc->setUnloaded(ViewPosition {docObject["cursor"].toInt(),
+                                           docObject["verticalScroll"].toInt(),
+                                           docObject["horizontalScroll"].toInt()});
+            addDocToArea(doc, pArea);
+            if (j == areaObject["current"].toInt())
+            {
+                pCurrentWdw = mDocRegistry.getSubWindow(doc);
+            }
+        }
+
+        if (pCurrentWdw)
+        {
+            pArea->setActiveSubWindow(pCurrentWdw);
         }
     }
+    mRestoringSession = false;
 
-    // doc name is set on tab
-    int position = fileName.lastIndexOf(QChar{'/'});
-    newView->setWindowTitle(fileName.mid(position + 1));
-    // doc snaps current content state
-    newView->setBeginTextState();
+    // shown tabs are read at once, others are read on their first activation
+    for (const auto &area : mDocAreas)
+    {
+        onSubWindowActivated(area->currentSubWindow());
+    }
+
+    const int activeArea = session["activeArea"].toInt();
+    if (activeArea >= 0 && activeArea < mDocAreas.size() && mDocAreas[activeArea]->currentSubWindow())
+    {
+        mDocAreas[activeArea]->currentSubWindow()->widget()->setFocus();
+    }
 }
 
-bool DocumentManager::saveDocument()
+void DocumentManager::openDocument(const QString &fileName, bool load)
 {
-    // receive current doc
-    auto pCurrentDocument = getCurrentDocument();
-
-    if (!pCurrentDocument)
+    // checks if doc is not already opened
+    auto pOpenedDoc = mDocRegistry.findByPath(fileName);
+    // if doc is already opened - it becomes active
+    if (pOpenedDoc)
     {
-        return false;
+        mDocRegistry.getArea(pOpenedDoc)->setActiveSubWindow(mDocRegistry.getSubWindow(pOpenedDoc));
+        return;
     }
 
-    // check if doc was modified
-    if (!pCurrentDocument->isChanged())
+    // select doc area to accomodate new doc
+    auto placementArea = selectAreaForPlacement();
+
+    if (!placementArea)
     {
-        return false;
+        throw DocumentPlacementFailure();
     }
 
-    // content is written to file
-    try
-    {
-        FileManager().writeToFile
-                (pCurrentDocument->getFileName(),
-                 pCurrentDocument->toPlainText());
+    // create new view
+    CodeEditor *newView = createDoc(fileName);
 
+    // doc is added to doc area & unfolded
+    addDocToArea(newView, placementArea);
+
+    // if necessary - doc content is read from file & placed in doc,
+    // doc of file which can't be opened isn't left empty
+    if (load)
+    {
+        try
+        {
+            loadFile(newView, fileName);
+        } catch (const FileOpeningFailure&)
+        {
+            closeLoadingDocument(newView);
+            throw;
+        }
     }
-    catch (const FileOpeningFailure&)
+
+    // doc snaps current content state,
+    // loaded doc does it itself when the whole content is read
+    if (!load)
     {
-        throw;
+        newView->setBeginTextState();
     }
+}
 
-    // doc snaps current content state
-    pCurrentDocument->setBeginTextState();
-    return true;
+bool DocumentManager::saveDocument()
+{
+    // receive current doc & start saving it if it was modified
+    return saveDocument(getCurrentDocument());
 }
 
 bool DocumentManager::saveAllDocuments()
 {
     bool savedChanges = false;
 
-    // saves changes to every doc in every doc area
+    // saves of every modified doc in every doc area are started at once
+    // & are written in parallel
     for (const auto &area : mDocAreas)
     {
         auto openedDocs = area->subWindowList();
 
         for (const auto &subWdw : openedDocs)
         {
-            try
+            // doc shown in several views is saved once
+            auto doc = qobject_cast<CodeEditor*>(subWdw->widget());
+            if (doc && doc->isPrimaryView())
             {
                 // savedChanges is set to true if at lease one document
-                // was saved
-                savedChanges |= saveDocument(qobject_cast<CodeEditor*>(subWdw->widget()));
-            }
-            catch (const FileOpeningFailure&)
-            {
-                throw;
+                // is being saved
+                savedChanges |= saveDocument(doc);
             }
         }
     }
     return savedChanges;
 }
 
+bool DocumentManager::waitForSaves()
+{
+    mFailedSavesCount = 0;
+    mpFileSaver->waitForDone();
+    return !mFailedSavesCount;
+}
+
+void DocumentManager::onSaveFinished(int requestId, const QString &fileName, bool success)
+{
+    PendingSave pendingSave = mPendingSaves.take(requestId);
+    if (!success)
+    {
+        ++mFailedSavesCount;
+        emit documentSavingFailed(fileName);
+        return;
+    }
+
+    rememberWrittenFile(fileName);
+    // file which was removed on disk is watched again when it's written
+    if (pendingSave.mpDoc)
+    {
+        mpFileWatcher->watch(fileName);
+    }
+    // file replaced on save gets new key, so it's found by it when it's renamed later
+    if (projectOpened())
+    {
+        FileDb().updateFileIdentityAsync(fileName);
+    }
+
+    // doc could be closed or edited while it was written,
+    // so saved snapshot & not current content becomes its saved state
+    mpRecoveryJournal->markSaved(fileName);
+    if (pendingSave.mpDoc)
+    {
+        pendingSave.mpDoc->setSavedState(pendingSave.mRevision, pendingSave.mContent);
+        // edits made during write are journaled against saved content
+        if (pendingSave.mpDoc->isChanged())
+        {
+            mpRecoveryJournal->appendEdit(fileName, 0, pendingSave.mContent.size(),
+                                          pendingSave.mpDoc->toPlainText());
+        }
+    }
+    emit documentSaved(fileName);
+}
+
 void DocumentManager::saveDocumentAs(CodeEditor *currentDocument, const QString &fileName)
 {
+    // partially loaded doc would overwrite file with a part of content
+    if (currentDocument->isLoading())
+    {
+        return;
+    }
+
     try
     {
         // doc is saved using new file name
         saveDocument(fileName, currentDocument->toPlainText());
+        rememberWrittenFile(fileName);
     }
     catch (const QException&)
     {
         throw;
     }
 
-    // opened doc represents newly created file
-    currentDocument->setFileName(fileName);
+    // opened doc represents newly created file in all its views
+    mpRecoveryJournal->markSaved(currentDocument->getFileName());
     int position = fileName.lastIndexOf(QChar{'/'});
-    currentDocument->setWindowTitle(fileName.mid(position + 1));
+    for (const auto &view : currentDocument->getViews())
+    {
+        view->setFileName(fileName);
+        view->setWindowTitle(fileName.mid(position + 1));
+        mDocRegistry.setFileName(view, fileName);
+    }
+    mpFileWatcher->watch(fileName);
     // doc snaps current content state
     currentDocument->setBeginTextState();
+    mpRecoveryJournal->markSaved(fileName);
 }
 
 void DocumentManager::loadFile(CodeEditor *newView, const QString &fileName)
 {
-    QString readResult;
+    // file is read on worker thread & its content is streamed to opened doc,
+    // loader belongs to doc, so it's stopped when doc is closed
+    AsyncFileLoader *pLoader = new AsyncFileLoader(newView);
 
     try
     {
-        readResult = FileManager().readFromFile(fileName);
+        pLoader->start(fileName);
     }
     catch (const FileOpeningFailure&)
     {
+        delete pLoader;
         throw;
     }
-    // loads file content to opened doc
-    newView->setPlainText(readResult);
+    newView->beginLoading();
+
+    connect(pLoader, &AsyncFileLoader::chunkLoaded, newView, [newView, pLoader](const QString &text)
+    {
+        newView->appendLoadedText(text);
+        pLoader->chunkProcessed();
+    });
+    connect(pLoader, &AsyncFileLoader::progressChanged, this, [this, fileName](int percent)
+    {
+        emit documentLoadingProgress(fileName, percent);
+    });
+    connect(pLoader, &AsyncFileLoader::loadingFinished, this, [this, newView, pLoader, fileName]()
+    {
+        newView->finishLoading();
+        // edits recovered after crash are applied to loaded content, so doc stays modified
+        if (mRecoveredContents.contains(fileName))
+        {
+            newView->replaceContent(mRecoveredContents.take(fileName));
+        }
+        pLoader->deleteLater();
+        emit documentLoadingFinished(fileName);
+    });
+    connect(pLoader, &AsyncFileLoader::loadingFailed, this, [this, newView, pLoader, fileName]()
+    {
+        pLoader->deleteLater();
+        closeLoadingDocument(newView);
+        emit documentLoadingFailed(fileName);
+    });
+}
+
+void DocumentManager::closeLoadingDocument(CodeEditor *doc)
+{
+    // partially loaded doc is not modified, so it's closed without prompt
+    auto pSubWdw = qobject_cast<QMdiSubWindow*>(doc->parent());
+    if (pSubWdw)
+    {
+        pSubWdw->close();
+    }
+}
+
+void DocumentManager::cancelLoading()
+{
+    for (const auto &area : mDocAreas)
+    {
+        for (const auto &wdw : area->subWindowList())
+        {
+            auto doc = qobject_cast<CodeEditor*>(wdw->widget());
+            if (doc && doc->isLoading())
+            {
+                closeLoadingDocument(doc);
+            }
+        }
+    }
 }
 
 void DocumentManager::onSplit(Qt::Orientation orientation)
 {
+    // doc in focus is shown in new doc area as one more view of the same document,
+    // loaded doc is shown when the whole content is read
+    auto pDocInFocus = getLastDocumentInFocus();
+    if (pDocInFocus && pDocInFocus->isLoading())
+    {
+        pDocInFocus = nullptr;
+    }
+
     // if number of doc areas is less than 2 -
     // then new doc area is added & orientation is set according to
     if (mDocAreas.size() < 2)
     {
         mpSplitter->setOrientation(orientation);
         splitWindow();
+        if (pDocInFocus)
+        {
+            addDocToArea(createDoc(pDocInFocus->getFileName(), pDocInFocus), mDocAreas.back());
+        }
         return;
     }
     // if current orientation matches passed arg
@@ -215,6 +501,10 @@ void DocumentManager::onSplit(Qt::Orientation orientation)
     if (orientation == mpSplitter->orientation())
     {
         splitWindow();
+        if (pDocInFocus)
+        {
+            addDocToArea(createDoc(pDocInFocus->getFileName(), pDocInFocus), mDocAreas.back());
+        }
         return;
     }
 
@@ -239,26 +529,39 @@ void DocumentManager::onFocusChanged(QWidget *old, QWidget *)
 
 void DocumentManager::onCloseDocument(CodeEditor *doc)
 {
-    // if only one doc area left - it will not be removed
-    if (mDocAreas.size() == 1)
+    // if we remove doc we must make sure that ptr to it (mpPrevEditorInFocus)
+    // is brought to safe condition
+    if (doc == mpPrevEditorInFocus)
     {
-        return;
+        mpPrevEditorInFocus = nullptr;
     }
 
     // find area to be removed
-    auto placementArea = getArea(doc);
+    auto placementArea = mDocRegistry.getArea(doc);
+    // closed doc can't be opened again by the same view
+    mDocRegistry.remove(doc);
 
-    // if area is not found or has other opened docs
-    if (!placementArea || placementArea->subWindowList().size() > 1)
+    if (doc->isLoading())
+    {
+        mRecoveredContents.remove(doc->getFileName());
+        emit documentLoadingCancelled(doc->getFileName());
+    }
+    // unsaved edits of closed doc are discarded
+    if (doc->getViews().size() == 1)
+    {
+        mpRecoveryJournal->markSaved(doc->getFileName());
+    }
+
+    // if only one doc area left - it will not be removed
+    if (mDocAreas.size() == 1)
     {
         return;
     }
 
-    // if we remove doc we must make sure that ptr to it (mpPrevEditorInFocus)
-    // is brought to safe condition
-    if (doc == mpPrevEditorInFocus)
+    // if area is not found or has other opened docs
+    if (!placementArea || placementArea->subWindowList().size() > 1)
     {
-        mpPrevEditorInFocus = nullptr;
+        return;
     }
 
     // area is removed from container
@@ -268,6 +571,135 @@ void DocumentManager::onCloseDocument(CodeEditor *doc)
     placementArea->deleteLater();
 }
 
+void DocumentManager::onSubWindowActivated(QMdiSubWindow *pSubWdw)
+{
+    auto doc = pSubWdw ? qobject_cast<CodeEditor*>(pSubWdw->widget()) : nullptr;
+    if (!doc || mRestoringSession)
+    {
+        return;
+    }
+
+    // tab restored from session reads its file in background when it's activated first time
+    if (doc->isUnloaded() && !doc->hasContentBlob())
+    {
+        try
+        {
+            loadFile(doc, doc->getFileName());
+        }
+        catch (const FileOpeningFailure&)
+        {
+            closeLoadingDocument(doc);
+            emit documentLoadingFailed(doc->getFileName());
+            return;
+        }
+    }
+
+    // activated doc is restored if it was unloaded,
+    // other inactive docs may be unloaded instead
+    mpTabMemoryManager->touch(doc);
+    mpTabMemoryManager->enforceBudget(shownDocuments());
+}
+
+void DocumentManager::onFilesChanged(const QStringList &fileNames)
+{
+    QStringList changedDocuments;
+    for (const auto &fileName : fileNames)
+    {
+        // file which was moved, removed or replaced gets its id by its identity again
+        DbIdCache::getDefaultCache().forgetFile(fileName);
+
+        auto doc = mDocRegistry.findByPath(fileName);
+        // file of closed doc isn't watched anymore
+        if (!doc)
+        {
+            mpFileWatcher->unwatch(fileName);
+            continue;
+        }
+
+        // removed file is written again when doc is saved,
+        // file written by IDE itself is not reloaded
+        QFileInfo fileInfo(fileName);
+        if (!fileInfo.exists() || mWrittenFilesTimes.value(fileName) == fileInfo.lastModified())
+        {
+            continue;
+        }
+        // content changed outside of IDE is the identity of file when it's renamed later
+        if (projectOpened())
+        {
+            FileDb().updateFileIdentityAsync(fileName);
+        }
+
+        // loaded doc gets content which is being read,
+        // unloaded doc reads its file instead of its outdated blob when it's activated
+        if (doc->isLoading())
+        {
+            continue;
+        }
+        if (doc->isUnloaded())
+        {
+            doc->setUnloaded(doc->getViewPosition());
+            continue;
+        }
+
+        // changes of user are never replaced without asking
+        if (doc->isChanged())
+        {
+            changedDocuments << doc->getFileName();
+            continue;
+        }
+        reloadDocument(doc->getFileName());
+    }
+
+    // user is asked once about the whole batch
+    if (!changedDocuments.isEmpty())
+    {
+        emit documentsChangedExternally(changedDocuments);
+    }
+}
+
+void DocumentManager::reloadDocument(const QString &fileName)
+{
+    auto doc = mDocRegistry.findByPath(fileName);
+    if (!doc || doc->isLoading())
+    {
+        return;
+    }
+
+    QString content;
+    try
+    {
+        content = FileManager().readFromFile(fileName);
+    }
+    catch (const FileOpeningFailure&)
+    {
+        return;
+    }
+    doc->reloadContent(content);
+    mpRecoveryJournal->markSaved(doc->getFileName());
+}
+
+QHash<QString, QString> DocumentManager::takeRecoveredDocuments()
+{
+    return mpRecoveryJournal->takeRecoveredContents();
+}
+
+void DocumentManager::openRecoveredDocuments(const QHash<QString, QString> &recoveredDocuments)
+{
+    for (auto it = recoveredDocuments.cbegin(); it != recoveredDocuments.cend(); ++it)
+    {
+        // recovered text is set when doc content is read
+        mRecoveredContents.insert(it.key(), it.value());
+        try
+        {
+            openDocument(it.key(), true);
+        }
+        catch (const QException&)
+        {
+            mRecoveredContents.remove(it.key());
+        }
+    }
+}
+
 void DocumentManager::onOpenDocument(const QString &fileName)
 {
     qDebug() << "open doc slot";
@@ -280,18 +712,42 @@ QMdiArea* DocumentManager::createMdiArea()
     QMdiArea *pMdiArea = new QMdiArea;
     pMdiArea->setTabsClosable(true);
     pMdiArea->setViewMode(QMdiArea::TabbedView);
+    connect(pMdiArea, &QMdiArea::subWindowActivated, this, &DocumentManager::onSubWindowActivated);
     return pMdiArea;
 }
 
-CodeEditor* DocumentManager::createDoc(const QString &fileName)
+CodeEditor* DocumentManager::createDoc(const QString &fileName, CodeEditor *pDocumentView)
 {
-    CodeEditor *newView = new CodeEditor(nullptr, fileName);
+    CodeEditor *newView = new CodeEditor(nullptr, fileName, pDocumentView);
     connect(newView, &CodeEditor::closeDocEventOccured, this, &DocumentManager::onCloseDocument);
     connect(newView, &CodeEditor::openDocument, this, &DocumentManager::onOpenDocument);
+    connect(newView, &CodeEditor::aboutToWriteFile, mpFileSaver, &AsyncFileSaver::waitForFile);
+    connect(newView, &CodeEditor::contentEdited, this,
+            [this, newView](int position, int charsRemoved, const QString &insertedText)
+    {
+        mpRecoveryJournal->appendEdit(newView->getFileName(), position, charsRemoved, insertedText);
+    });
+    connect(newView, &QObject::destroyed, this, [this, newView]()
+    {
+        mDocRegistry.remove(newView);
+    });
+    newView->setDocumentRegistry(&mDocRegistry);
     newView->setFocusPolicy(Qt::StrongFocus);
     return newView;
 }
 
+void DocumentManager::addDocToArea(CodeEditor *doc, QMdiArea *area)
+{
+    // doc is added to doc area & unfolded
+    mDocRegistry.add(doc, area->addSubWindow(doc), area);
+    mpFileWatcher->watch(doc->getFileName());
+    doc->setWindowState(Qt::WindowMaximized);
+
+    // doc name is set on tab
+    int position = doc->getFileName().lastIndexOf(QChar{'/'});
+    doc->setWindowTitle(doc->getFileName().mid(position + 1));
+}
+
 QMdiArea* DocumentManager::selectAreaForPlacement()
 {
     // check if there are any doc areas
@@ -321,29 +777,10 @@ QMdiArea* DocumentManager::selectAreaForPlacement()
 
 QMdiSubWindow* DocumentManager::openedDoc(const QString &fileName)
 {
-    QList<QMdiSubWindow*>::const_iterator openedDocIter;
-
-    // search for doc with specified name in every area
-    for (const auto &area: mDocAreas)
-    {
-        auto subWdwList = area->subWindowList();
-
-        openedDocIter = std::find_if(subWdwList.cbegin(), subWdwList.cend(),
-                                     [&fileName](const auto &wdw)
-        {
-            auto doc = qobject_cast<CodeEditor*>(wdw->widget());
-            return doc ? doc->getFileName() == fileName : false;
-        });
-
-        if (openedDocIter != subWdwList.end())
-        {
-            return *openedDocIter;
-        }
-    }
-
     // if document is opened - ptr to it is returned
     // otherwise null is returned
-    return nullptr;
+    auto doc = mDocRegistry.findByPath(fileName);
+    return doc ? mDocRegistry.getSubWindow(doc) : nullptr;
 }
 
 QMdiArea* DocumentManager::lastAreaInFocus()
@@ -354,74 +791,44 @@ QMdiArea* DocumentManager::lastAreaInFocus()
         return nullptr;
     }
 
-    // search for area which accomodates last doc in focus
-    for (const auto &area: mDocAreas)
+    // area which accomodates last doc in focus is used
+    // only if this doc is still current one in it
+    auto pArea = mDocRegistry.getArea(mpPrevEditorInFocus);
+    if (pArea && pArea->currentSubWindow() == mDocRegistry.getSubWindow(mpPrevEditorInFocus))
     {
-        auto currentWindow = area->currentSubWindow();
-
-        if (currentWindow)
-        {
-            auto doc = qobject_cast<CodeEditor*>(currentWindow->widget());
-            if (doc && (doc == mpPrevEditorInFocus))
-            {
-                return area;
-            }
-        }
+        return pArea;
     }
-
-    // if document-to-pointer is equal to pointer to previous document in focus
-    // then pointer to it is returned
-    // otherwise null is returned
     return nullptr;
 }
 
 QMdiArea* DocumentManager::areaInFocus()
 {
-    // search for area which accomodates current doc in focus
-    for (const auto &area: mDocAreas)
+    // area which accomodates current doc in focus is returned
+    // otherwise null is returned
+    auto doc = qobject_cast<CodeEditor*>(QApplication::focusWidget());
+    if (!doc)
     {
-        auto currentWindow = area->currentSubWindow();
-
-        if (currentWindow)
-        {
-            auto doc = qobject_cast<CodeEditor*>(currentWindow->widget());
-
-            if (doc && doc->hasFocus())
-            {
-                return area;
-            }
-        }
+        return nullptr;
     }
 
-    // if document is in focus - ptr to it is returned
-    // otherwise null is returned
-    return nullptr;
+    auto pArea = mDocRegistry.getArea(doc);
+    return pArea && pArea->currentSubWindow() == mDocRegistry.getSubWindow(doc) ? pArea : nullptr;
 }
 
-QMdiArea* DocumentManager::getArea(CodeEditor *doc)
+QSet<CodeEditor*> DocumentManager::shownDocuments()
 {
-    QList<QMdiSubWindow*>::const_iterator areaIter;
-    // search for area which accomodates current doc
+    // current doc of every area is shown
+    QSet<CodeEditor*> rShownDocs;
     for (const auto &area: mDocAreas)
     {
-        auto subWdwList = area->subWindowList();
-
-        areaIter = std::find_if(subWdwList.cbegin(), subWdwList.cend(),
-                                [&doc](const auto &document)
-        {
-            auto currentDoc = qobject_cast<CodeEditor*>(document->widget());
-            return currentDoc ? (currentDoc == doc) : false;
-        });
-
-        if (areaIter != subWdwList.end())
+        auto currentWindow = area->currentSubWindow();
+        auto doc = currentWindow ? qobject_cast<CodeEditor*>(currentWindow->widget()) : nullptr;
+        if (doc)
         {
-            return area;
+            rShownDocs.insert(doc);
         }
     }
-
-    // if document is found - ptr to it is returned
-    // otherwise null is returned
-    return nullptr;
+    return rShownDocs;
 }
 
 CodeEditor* DocumentManager::getCurrentDocument()
@@ -446,6 +853,13 @@ CodeEditor* DocumentManager::getCurrentDocument()
     return pCurrentDocument ? qobject_cast<CodeEditor*>(pCurrentDocument->widget()) : nullptr;
 }
 
+CodeEditor* DocumentManager::getLastDocumentInFocus()
+{
+    // used by tool windows which take focus from the document (e.g. Find/Replace)
+    auto pCurrentDocument = getCurrentDocument();
+    return pCurrentDocument ? pCurrentDocument : mpPrevEditorInFocus;
+}
+
 void DocumentManager::closeCurrentDocument()
 {
     // get current document
@@ -476,6 +890,8 @@ void DocumentManager::closeAllDocumentsWithoutSaving()
     {
         auto pDocArea = mDocAreas.back();
         mDocAreas.pop_back();
+        // docs are closed, so they're not registered as opened anymore
+        pDocArea->closeAllSubWindows();
         pDocArea->close();
     }
 
@@ -485,6 +901,8 @@ void DocumentManager::closeAllDocumentsWithoutSaving()
     {
         window->close();
     }
+    mpFileWatcher->clear();
+    mWrittenFilesTimes.clear();
 }
 
 QVector<CodeEditor*> DocumentManager::getChangedDocuments()
@@ -504,7 +922,8 @@ QVector<CodeEditor*> DocumentManager::getChangedDocuments()
             {
                 auto doc = qobject_cast<CodeEditor*>(wdw->widget());
 
-                if (doc && doc->isChanged())
+                // doc shown in several views is listed once
+                if (doc && doc->isPrimaryView() && doc->isChanged())
                 {
                     changedDocuments.push_back(doc);
                 }
@@ -514,6 +933,49 @@ QVector<CodeEditor*> DocumentManager::getChangedDocuments()
     return changedDocuments;
 }
 
+QHash<QString, QString> DocumentManager::getUnsavedDocuments()
+{
+    QHash<QString, QString> unsavedDocuments;
+    for (const auto &doc : getChangedDocuments())
+    {
+        unsavedDocuments.insert(DocumentRegistry::pathKey(doc->getFileName()), doc->toPlainText());
+    }
+    return unsavedDocuments;
+}
+
+void DocumentManager::moveCursorToLine(const QString &fileName, const int line)
+{
+    QMdiSubWindow *pWdw = openedDoc(fileName);
+    if (!pWdw)
+    {
+        return;
+    }
+
+    pWdw->mdiArea()->setActiveSubWindow(pWdw);
+    auto doc = qobject_cast<CodeEditor*>(pWdw->widget());
+    if (!doc)
+    {
+        return;
+    }
+
+    // line of doc which is still being loaded may be not read yet
+    if (doc->isLoading())
+    {
+        auto pConnection = std::make_shared<QMetaObject::Connection>();
+        *pConnection = connect(this, &DocumentManager::documentLoadingFinished, doc,
+                               [doc, fileName, line, pConnection](const QString &loadedFileName)
+        {
+            if (loadedFileName == fileName)
+            {
+                QObject::disconnect(*pConnection);
+                doc->moveCursorToLine(line);
+            }
+        });
+        return;
+    }
+    doc->moveCursorToLine(line);
+}
+
 void DocumentManager::combineDocAreas()
 {
     if (mDocAreas.size() < 2)
@@ -541,27 +1003,31 @@ void DocumentManager::combineDocAreas()
                 {
                     // window is removed from doc area
                     (*areaIter)->removeSubWindow(wdw);
-                    QString fileName = doc->getFileName();
 
-                    // new doc view is created
-                    CodeEditor *newView = createDoc(fileName);
-
-                    // text from opened document is placed on new document view
-                    newView->setPlainText(doc->toPlainText());
-
-                    // initial document state is passed to new view
-                    // in order to keep track of doc modification
-                    newView->setTextState(doc->getBeginTextState());
-
-                    // new view is placed on front doc area
-                    mDocAreas.front()->addSubWindow(newView);
-                    newView->setWindowState(Qt::WindowMaximized);
-
-                    // doc name is set on tab
-                    int position = fileName.lastIndexOf(QChar{'/'});
-                    newView->setWindowTitle(fileName.mid(position + 1));
-
-                    delete wdw;
+                    // if first doc area already shows this document - extra view is dropped,
+                    // otherwise window is moved as is: document, comments & loading are kept
+                    auto frontWindows = mDocAreas.front()->subWindowList();
+                    auto shownIter = std::find_if(frontWindows.cbegin(), frontWindows.cend(),
+                                                  [&doc](const auto &frontWdw)
+                    {
+                        auto frontDoc = qobject_cast<CodeEditor*>(frontWdw->widget());
+                        return frontDoc ? frontDoc->document() == doc->document() : false;
+                    });
+
+                    if (shownIter != frontWindows.cend())
+                    {
+                        if (doc == mpPrevEditorInFocus)
+                        {
+                            mpPrevEditorInFocus = nullptr;
+                        }
+                        delete wdw;
+                        continue;
+                    }
+
+                    mDocAreas.front()->addSubWindow(wdw);
+                    mDocRegistry.setArea(doc, mDocAreas.front());
+                    wdw->setWindowState(Qt::WindowMaximized);
+                    wdw->show();
                 }
             }
         }
@@ -593,18 +1059,8 @@ void DocumentManager::closeEmptyDocArea()
 }
 
 bool DocumentManager::fileBelongsToCurrentProject(const QString &fileName) const
-{    
-    QDirIterator dirIter(currentProject, QDir::Files, QDirIterator::Subdirectories);
-
-    while (dirIter.hasNext())
-    {
-        dirIter.next();        
-        if (dirIter.filePath() == fileName)
-        {
-            return true;
-        }
-    }
-    return false;
+{
+    return mpProjectFileIndex->containsFile(fileName);
 }
 
 bool DocumentManager::projectOpened()
@@ -669,18 +1125,11 @@ bool DocumentManager::saveDocument(CodeEditor *doc)
     {
         return false;
     }
-    // save document content to file
-    try
-    {
-        FileManager().writeToFile(doc->getFileName(), doc->toPlainText());
-        // snap current doc content state
-        doc->setBeginTextState();
-        return true;
-    }
-    catch (const FileOpeningFailure&)
-    {
-        throw;
-    }
+    // content snapshot is written on worker thread
+    const QString content = doc->toPlainText();
+    const int requestId = mpFileSaver->save(doc->getFileName(), content);
+    mPendingSaves.insert(requestId, PendingSave {doc, doc->getRevision(), content});
+    return true;
 }
 
 bool DocumentManager::saveDocument(const QString &fileName)
@@ -699,33 +1148,14 @@ bool DocumentManager::saveDocument(const QString &fileName)
         return false;
     }
 
-    // check if doc was modified
-    if (!openedDocument->isChanged())
-    {
-        return true;
-    }
-
-    // content is written to file
-    try
-    {
-        FileManager().writeToFile
-                (fileName,
-                 openedDocument->toPlainText());
-
-    }
-    catch (const FileOpeningFailure&)
-    {
-        throw;
-    }
-
-    // doc snaps current content state
-    openedDocument->setBeginTextState();
-
+    saveDocument(openedDocument);
     return true;
 }
 
 void DocumentManager::saveDocument(const QString &fileName, const QString &fileContent)
 {    
+    // older snapshot of file which is still being saved would overwrite this content
+    mpFileSaver->waitForFile(fileName);
     try
     {
         FileManager().writeToFile
@@ -738,6 +1168,20 @@ void DocumentManager::saveDocument(const QString &fileName, const QString &fileC
     }
 }
 
+QString DocumentManager::getSessionFileName() const
+{
+    // every project has its own session, file is named by hash of project path
+    const QByteArray projectPath = QDir::cleanPath(QDir(currentProject).absolutePath()).toUtf8();
+    const QString hash = QString::fromLatin1(QCryptographicHash::hash(projectPath, QCryptographicHash::Sha1).toHex());
+    QDir sessionsDir(QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath(sessionsDirName));
+    return sessionsDir.filePath(hash + sessionFileSuffix);
+}
+
+void DocumentManager::rememberWrittenFile(const QString &fileName)
+{
+    mWrittenFilesTimes.insert(fileName, QFileInfo(fileName).lastModified());
+}
+
 void DocumentManager::setAllDocumentsNotModified()
 {
     for (auto &area: mDocAreas)
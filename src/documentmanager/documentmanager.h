@@ -5,15 +5,30 @@
 #include <QObject>
 
 #include <QMdiSubWindow>
+#include <QPointer>
 #include <QDirIterator>
 #include <QMessageBox>
 #include <QSplitter>
 #include <algorithm>
 #include <QMdiArea>
 #include <QVector>
+#include <QDateTime>
+#include <QHash>
+#include <QSet>
 #include <QDebug>
 #include <QDir>
+
+#include "documentregistry.h"
+
+// opened tabs & layout of doc areas are kept in this file of project
+extern const char *sessionFileName;
+
 class QMdiSubWindow;
+class ProjectFileIndex;
+class AsyncFileSaver;
+class TabMemoryManager;
+class RecoveryJournal;
+class DocumentFileWatcher;
 class CodeEditor;
 class QSplitter;
 class QMdiArea;
@@ -25,11 +40,39 @@ class DocumentManager: public QObject
     // object responsible for laying out several doc area
     QSplitter *mpSplitter;
     QVector<QMdiArea*> mDocAreas;
+    // every opened doc view with its area & sub window
+    DocumentRegistry mDocRegistry;
     // pointer to previous document in focus
     // is used when document loses focus upon user input
     // (e.g. when Project Viewer item is clicked to open another document)
     CodeEditor *mpPrevEditorInFocus;
     QString currentProject;
+    // files of opened project
+    ProjectFileIndex *mpProjectFileIndex;
+
+    // docs are saved in background, content snapshot becomes saved state
+    // of doc when its write is finished
+    struct PendingSave
+    {
+        QPointer<CodeEditor> mpDoc;
+        quint64 mRevision;
+        QString mContent;
+    };
+    AsyncFileSaver *mpFileSaver;
+    QHash<int, PendingSave> mPendingSaves;
+    int mFailedSavesCount;
+    // content of inactive docs is unloaded when opened docs exceed memory budget
+    TabMemoryManager *mpTabMemoryManager;
+    // files of opened docs are watched, so their changes on disk are shown in docs,
+    // modification times of files written by IDE are kept to ignore their own changes
+    DocumentFileWatcher *mpFileWatcher;
+    QHash<QString, QDateTime> mWrittenFilesTimes;
+    // edits of unsaved docs are journaled, so they're recovered after crash,
+    // recovered text of doc which is being loaded is kept until its file is read
+    RecoveryJournal *mpRecoveryJournal;
+    QHash<QString, QString> mRecoveredContents;
+    // activation of placeholder tabs doesn't start loading until session is restored
+    bool mRestoringSession;
 
 public:
     explicit DocumentManager();
@@ -37,14 +80,25 @@ public:
     void openProject(const QString &path);
     const QString& getCurrentProjectPath()const;
     void closeCurrentProject();
+    ProjectFileIndex* getProjectFileIndex();
+    // opened tabs, their cursor & scroll positions and layout of doc areas are kept in project,
+    // restored tabs are empty until they're activated, so only shown docs are read at once
+    void saveSession();
+    void restoreSession();
     void openDocument(const QString &fileName, bool load = false);
     bool saveDocument();
     bool saveAllDocuments();
+    // blocks until all started saves are finished, returns false if any of them failed
+    bool waitForSaves();
     void saveDocumentAs(CodeEditor *currentDocument, const QString &fileName);
     CodeEditor* getCurrentDocument();
+    CodeEditor* getLastDocumentInFocus();
     void closeCurrentDocument();
     void closeAllDocumentsWithoutSaving();
     QVector<CodeEditor*> getChangedDocuments();
+    // path key of file (see DocumentRegistry::pathKey) -> text of every modified document
+    QHash<QString, QString> getUnsavedDocuments();
+    void moveCursorToLine(const QString &fileName, const int line);
     void combineDocAreas();
     void closeEmptyDocArea();    
     bool fileBelongsToCurrentProject(const QString &fileName)const;
@@ -64,6 +118,24 @@ public:
     void setStyle(CodeEditor *doc, const QString &styleName);
     void setFontFamily(CodeEditor *doc, const QString &fontFamily);
     void setFontSize(CodeEditor *doc, const QString &fontSize);    
+    // closes documents which are still being loaded
+    void cancelLoading();
+    // content of opened doc is replaced by the current content of its file
+    void reloadDocument(const QString &fileName);
+    // file name -> recovered text of docs which were left unsaved by crashed session
+    QHash<QString, QString> takeRecoveredDocuments();
+    // recovered docs are opened modified, so user decides whether they're saved
+    void openRecoveredDocuments(const QHash<QString, QString> &recoveredDocuments);
+
+signals:
+    void documentLoadingProgress(const QString &fileName, int percent);
+    void documentLoadingFinished(const QString &fileName);
+    void documentLoadingFailed(const QString &fileName);
+    void documentLoadingCancelled(const QString &fileName);
+    void documentSaved(const QString &fileName);
+    void documentSavingFailed(const QString &fileName);
+    // files of modified docs were changed on disk, so user decides whether docs are reloaded
+    void documentsChangedExternally(const QStringList &fileNames);
 
 public slots:
     void onSplit(Qt::Orientation orientation);
@@ -71,21 +143,32 @@ public slots:
     void onCloseDocument(CodeEditor *doc);
     void onOpenDocument(const QString &fileName);
 
+private slots:
+    void onSaveFinished(int requestId, const QString &fileName, bool success);
+    void onSubWindowActivated(QMdiSubWindow *pSubWdw);
+    void onFilesChanged(const QStringList &fileNames);
+
 private:
     void splitWindow();
     void loadFile(CodeEditor *newView, const QString &fileName);
+    void closeLoadingDocument(CodeEditor *doc);
 
     QMdiArea* createMdiArea();
-    CodeEditor* createDoc(const QString &fileName);
+    // if pDocumentView is passed, created view shares its document
+    CodeEditor* createDoc(const QString &fileName, CodeEditor *pDocumentView = nullptr);
+    void addDocToArea(CodeEditor *doc, QMdiArea *area);
     QMdiArea* selectAreaForPlacement();
     QMdiSubWindow* openedDoc(const QString &fileName);
     QMdiArea* lastAreaInFocus();
     QMdiArea* areaInFocus();
-    QMdiArea* getArea(CodeEditor *doc);
+    QSet<CodeEditor*> shownDocuments();
     bool saveDocument(CodeEditor *doc);
     bool saveDocument(const QString &fileName);
     void saveDocument(const QString &fileName, const QString &fileContent);
     void setAllDocumentsNotModified();
+    void rememberWrittenFile(const QString &fileName);
+    // session is kept in data of application, not in project tree (under version control)
+    QString getSessionFileName() const;
 };
 
 #endif // MDIAREA_H
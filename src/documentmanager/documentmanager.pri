@@ -2,7 +2,15 @@ DEPENDPATH += $$PWD
 INCLUDEPATH += $$PWD
 
 HEADERS += \
-    $$PWD/documentmanager.h
+    $$PWD/documentfilewatcher.h \
+    $$PWD/documentmanager.h \
+    $$PWD/documentregistry.h \
+    $$PWD/recoveryjournal.h \
+    $$PWD/tabmemorymanager.h
 
 SOURCES += \
-    $$PWD/documentmanager.cpp
+    $$PWD/documentfilewatcher.cpp \
+    $$PWD/documentmanager.cpp \
+    $$PWD/documentregistry.cpp \
+    $$PWD/recoveryjournal.cpp \
+    $$PWD/tabmemorymanager.cpp
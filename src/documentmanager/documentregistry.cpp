@@ -0,0 +1,87 @@
+#include "documentregistry.h"
+
+#include <QFileInfo>
+#include <QDir>
+
+#include "codeeditor.h"
+
+void DocumentRegistry::add(CodeEditor *doc, QMdiSubWindow *pSubWdw, QMdiArea *pArea)
+{
+    remove(doc);
+    const QString key = pathKey(doc->getFileName());
+    mEntries.insert(doc, Entry {key, pSubWdw, pArea});
+    mDocsByPath[key].append(doc);
+}
+
+void DocumentRegistry::remove(CodeEditor *doc)
+{
+    // doc may be already destroyed, so only stored data is used
+    auto entryIter = mEntries.find(doc);
+    if (entryIter == mEntries.end())
+    {
+        return;
+    }
+
+    auto docsIter = mDocsByPath.find(entryIter->mPathKey);
+    if (docsIter != mDocsByPath.end())
+    {
+        docsIter->removeOne(doc);
+        if (docsIter->isEmpty())
+        {
+            mDocsByPath.erase(docsIter);
+        }
+    }
+    mEntries.erase(entryIter);
+}
+
+void DocumentRegistry::setArea(CodeEditor *doc, QMdiArea *pArea)
+{
+    auto entryIter = mEntries.find(doc);
+    if (entryIter != mEntries.end())
+    {
+        entryIter->mpArea = pArea;
+    }
+}
+
+void DocumentRegistry::setFileName(CodeEditor *doc, const QString &fileName)
+{
+    auto entryIter = mEntries.find(doc);
+    if (entryIter == mEntries.end())
+    {
+        return;
+    }
+
+    // doc is moved to the list of views of new file
+    const Entry entry = *entryIter;
+    remove(doc);
+    const QString key = pathKey(fileName);
+    mEntries.insert(doc, Entry {key, entry.mpSubWdw, entry.mpArea});
+    mDocsByPath[key].append(doc);
+}
+
+CodeEditor* DocumentRegistry::findByPath(const QString &fileName) const
+{
+    auto docsIter = mDocsByPath.constFind(pathKey(fileName));
+    return docsIter == mDocsByPath.cend() ? nullptr : docsIter->front();
+}
+
+QMdiSubWindow* DocumentRegistry::getSubWindow(CodeEditor *doc) const
+{
+    auto entryIter = mEntries.constFind(doc);
+    return entryIter == mEntries.cend() ? nullptr : entryIter->mpSubWdw;
+}
+
+QMdiArea* DocumentRegistry::getArea(CodeEditor *doc) const
+{
+    auto entryIter = mEntries.constFind(doc);
+    return entryIter == mEntries.cend() ? nullptr : entryIter->mpArea;
+}
+
+QString DocumentRegistry::pathKey(const QString &fileName)
+{
+    // links & relative parts are resolved for existing files,
+    // path of file which isn't created yet is only cleaned
+    QFileInfo fileInfo(fileName);
+    const QString canonicalPath = fileInfo.canonicalFilePath();
+    return canonicalPath.isEmpty() ? QDir::cleanPath(fileInfo.absoluteFilePath()) : canonicalPath;
+}
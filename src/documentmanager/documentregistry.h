@@ -0,0 +1,42 @@
+#ifndef DOCUMENTREGISTRY_H
+#define DOCUMENTREGISTRY_H
+
+#include <QVector>
+#include <QString>
+#include <QHash>
+
+class QMdiSubWindow;
+class CodeEditor;
+class QMdiArea;
+
+// index of opened doc views by file path & by view,
+// keeps doc area & sub window of every view
+class DocumentRegistry
+{
+public:
+    void add(CodeEditor *doc, QMdiSubWindow *pSubWdw, QMdiArea *pArea);
+    void remove(CodeEditor *doc);
+    void setArea(CodeEditor *doc, QMdiArea *pArea);
+    void setFileName(CodeEditor *doc, const QString &fileName);
+
+    // the first opened view of file or null if file isn't opened
+    CodeEditor* findByPath(const QString &fileName) const;
+    QMdiSubWindow* getSubWindow(CodeEditor *doc) const;
+    QMdiArea* getArea(CodeEditor *doc) const;
+
+    // equal paths to the same file give equal keys
+    static QString pathKey(const QString &fileName);
+
+private:
+
+    struct Entry
+    {
+        QString mPathKey;
+        QMdiSubWindow *mpSubWdw;
+        QMdiArea *mpArea;
+    };
+    QHash<CodeEditor*, Entry> mEntries;
+    QHash<QString, QVector<CodeEditor*>> mDocsByPath;
+};
+
+#endif // DOCUMENTREGISTRY_H
@@ -0,0 +1,349 @@
+#include "recoveryjournal.h"
+
+#include <QStandardPaths>
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QRunnable>
+#include <QVector>
+#include <QDebug>
+#include <QFile>
+#include <QDir>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "filemanager.h"
+#include "textdiff.h"
+#include "utils.h"
+
+namespace
+{
+
+const char *journalFileSuffix = ".journal";
+const char *lockFileSuffix = ".lock";
+
+void syncFile(QFile &file)
+{
+    // data is written to disk & not only to cache of OS
+    file.flush();
+#if defined(Q_OS_WIN)
+    _commit(file.handle());
+#elif defined(Q_OS_LINUX)
+    fdatasync(file.handle());
+#else
+    fsync(file.handle());
+#endif
+}
+
+}
+
+class JournalWriteTask: public QRunnable
+{
+public:
+    JournalWriteTask(const QString &journalFileName, const QByteArray &data, bool truncate):
+        mJournalFileName(journalFileName), mData(data), mTruncate(truncate)
+    {
+    }
+
+    void run() override
+    {
+        QFile journal(mJournalFileName);
+        if (!journal.open(mTruncate ? QIODevice::WriteOnly | QIODevice::Truncate
+                                    : QIODevice::WriteOnly | QIODevice::Append))
+        {
+            qDebug() << "recovery journal is not written";
+            return;
+        }
+        if (!mData.isEmpty())
+        {
+            journal.write(mData);
+        }
+        syncFile(journal);
+    }
+
+private:
+    QString mJournalFileName;
+    QByteArray mData;
+    bool mTruncate;
+};
+
+RecoveryJournal::RecoveryJournal(QObject *pParent):
+    QObject (pParent),
+    mJournalFailed(false)
+{
+    mWriterPool.setMaxThreadCount(1);
+    mFlushTimer.setSingleShot(true);
+    mFlushTimer.setInterval(JOURNAL_FLUSH_INTERVAL);
+    connect(&mFlushTimer, &QTimer::timeout, this, &RecoveryJournal::flush);
+}
+
+RecoveryJournal::~RecoveryJournal()
+{
+    // session is finished normally, so its edits are not recovered
+    mFlushTimer.stop();
+    mWriterPool.waitForDone();
+    if (mpJournalLock)
+    {
+        QFile::remove(mJournalFileName);
+    }
+}
+
+void RecoveryJournal::appendEdit(const QString &fileName, int position, int charsRemoved,
+                                 const QString &insertedText)
+{
+    if (!ensureJournalOpened())
+    {
+        return;
+    }
+
+    const qint32 fileId = getFileId(fileName);
+    QDataStream stream(&mBuffer, QIODevice::WriteOnly | QIODevice::Append);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    // edits are replayed on content which file had when doc became modified,
+    // so file is checked to be the same when they're recovered
+    if (!mUnsavedFiles.contains(fileId))
+    {
+        QFileInfo fileInfo(fileName);
+        const bool fileExists = fileInfo.exists();
+        stream << static_cast<quint8>(BeginRecord) << fileId << fileName
+               << (fileExists ? fileInfo.size() : qint64(-1))
+               << (fileExists ? fileInfo.lastModified().toMSecsSinceEpoch() : qint64(0));
+        mUnsavedFiles.insert(fileId);
+    }
+    stream << static_cast<quint8>(EditRecord) << fileId << static_cast<qint32>(position)
+           << static_cast<qint32>(charsRemoved) << insertedText;
+
+    // edit is written together with others made during flush interval
+    if (!mFlushTimer.isActive())
+    {
+        mFlushTimer.start();
+    }
+}
+
+void RecoveryJournal::markSaved(const QString &fileName)
+{
+    const int fileId = mFileIds.value(fileName, -1);
+    if (!mUnsavedFiles.remove(fileId))
+    {
+        return;
+    }
+
+    // all edits are saved, so journal doesn't need any of them
+    if (mUnsavedFiles.isEmpty())
+    {
+        mFlushTimer.stop();
+        mBuffer.clear();
+        mFileIds.clear();
+        enqueueWrite(QByteArray(), true);
+        return;
+    }
+
+    QDataStream stream(&mBuffer, QIODevice::WriteOnly | QIODevice::Append);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << static_cast<quint8>(SavedRecord) << static_cast<qint32>(fileId);
+    if (!mFlushTimer.isActive())
+    {
+        mFlushTimer.start();
+    }
+}
+
+QHash<QString, QString> RecoveryJournal::takeRecoveredContents()
+{
+    QHash<QString, QString> rRecoveredContents;
+    QDir journalsDir(getJournalsDir());
+    const QStringList journals = journalsDir.entryList(QStringList {QString("*") + journalFileSuffix}, QDir::Files);
+    for (const auto &journal : journals)
+    {
+        const QString journalFileName = journalsDir.filePath(journal);
+        if (journalFileName == mJournalFileName)
+        {
+            continue;
+        }
+
+        // journal of running session stays locked, lock of crashed session is stale
+        QLockFile lock(journalFileName + lockFileSuffix);
+        if (!lock.tryLock(0))
+        {
+            continue;
+        }
+        readJournal(journalFileName, rRecoveredContents);
+        QFile::remove(journalFileName);
+    }
+    return rRecoveredContents;
+}
+
+void RecoveryJournal::flush()
+{
+    if (!mBuffer.isEmpty())
+    {
+        enqueueWrite(mBuffer, false);
+        mBuffer.clear();
+    }
+}
+
+bool RecoveryJournal::ensureJournalOpened()
+{
+    if (mpJournalLock || mJournalFailed)
+    {
+        return !mJournalFailed;
+    }
+
+    const QString journalsDir = getJournalsDir();
+    mJournalFileName = QDir(journalsDir).filePath(QString::number(QCoreApplication::applicationPid())
+                                                  + journalFileSuffix);
+    std::unique_ptr<QLockFile> pLock(new QLockFile(mJournalFileName + lockFileSuffix));
+    if (!QDir().mkpath(journalsDir) || !pLock->tryLock(0))
+    {
+        // editing works as before, only recovery is not available
+        qDebug() << "recovery journal can't be created";
+        mJournalFailed = true;
+        return false;
+    }
+    mpJournalLock = std::move(pLock);
+    // file could be left by finished process with the same id
+    enqueueWrite(QByteArray(), true);
+    return true;
+}
+
+int RecoveryJournal::getFileId(const QString &fileName)
+{
+    auto it = mFileIds.find(fileName);
+    if (it == mFileIds.end())
+    {
+        it = mFileIds.insert(fileName, mFileIds.size());
+    }
+    return it.value();
+}
+
+void RecoveryJournal::enqueueWrite(const QByteArray &data, bool truncate)
+{
+    if (mpJournalLock)
+    {
+        mWriterPool.start(new JournalWriteTask(mJournalFileName, data, truncate));
+    }
+}
+
+QString RecoveryJournal::getJournalsDir()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath("recovery");
+}
+
+void RecoveryJournal::readJournal(const QString &journalFileName, QHash<QString, QString> &recoveredContents)
+{
+    struct Edit
+    {
+        qint32 mPosition;
+        qint32 mCharsRemoved;
+        QString mInsertedText;
+    };
+    struct FileEdits
+    {
+        QString mFileName;
+        qint64 mSize;
+        qint64 mLastModified;
+        QVector<Edit> mEdits;
+    };
+
+    QFile journal(journalFileName);
+    if (!journal.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+    QDataStream stream(&journal);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    QHash<qint32, FileEdits> files;
+    while (!stream.atEnd())
+    {
+        quint8 type = 0;
+        qint32 fileId = 0;
+        stream >> type >> fileId;
+        if (type == BeginRecord)
+        {
+            FileEdits fileEdits;
+            stream >> fileEdits.mFileName >> fileEdits.mSize >> fileEdits.mLastModified;
+            if (stream.status() == QDataStream::Ok)
+            {
+                files[fileId] = fileEdits;
+            }
+        }
+        else if (type == EditRecord)
+        {
+            Edit edit;
+            stream >> edit.mPosition >> edit.mCharsRemoved >> edit.mInsertedText;
+            if (stream.status() == QDataStream::Ok && files.contains(fileId))
+            {
+                files[fileId].mEdits.append(edit);
+            }
+        }
+        else if (type == SavedRecord)
+        {
+            files.remove(fileId);
+        }
+        else
+        {
+            break;
+        }
+
+        // the last record could be written partially when session crashed
+        if (stream.status() != QDataStream::Ok)
+        {
+            break;
+        }
+    }
+
+    for (const auto &fileEdits : files)
+    {
+        if (fileEdits.mEdits.isEmpty())
+        {
+            continue;
+        }
+
+        // file changed after doc became modified is not a base for its edits
+        QFileInfo fileInfo(fileEdits.mFileName);
+        const bool fileExists = fileInfo.exists();
+        if (fileExists != (fileEdits.mSize >= 0)
+                || (fileExists && (fileInfo.size() != fileEdits.mSize
+                                   || fileInfo.lastModified().toMSecsSinceEpoch() != fileEdits.mLastModified)))
+        {
+            continue;
+        }
+
+        QString text;
+        if (fileExists)
+        {
+            try
+            {
+                text = FileManager().readFromFile(fileEdits.mFileName);
+            }
+            catch (const FileOpeningFailure&)
+            {
+                continue;
+            }
+            // line breaks are single chars in doc, so positions of edits are counted this way
+            text = normalizeLineBreaks(text);
+        }
+
+        bool editsApplied = true;
+        for (const auto &edit : fileEdits.mEdits)
+        {
+            if (edit.mPosition < 0 || edit.mPosition > text.size() || edit.mCharsRemoved < 0)
+            {
+                editsApplied = false;
+                break;
+            }
+            text.replace(edit.mPosition, qMin(edit.mCharsRemoved, text.size() - edit.mPosition),
+                         edit.mInsertedText);
+        }
+        if (editsApplied)
+        {
+            recoveredContents.insert(fileEdits.mFileName, text);
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef RECOVERYJOURNAL_H
+#define RECOVERYJOURNAL_H
+
+#include <QThreadPool>
+#include <QByteArray>
+#include <QLockFile>
+#include <QObject>
+#include <QTimer>
+#include <QHash>
+#include <QSet>
+#include <memory>
+
+// buffered edits are written & synced to disk at most this long after they're made
+const int JOURNAL_FLUSH_INTERVAL = 300;
+
+// write-ahead log of edits of unsaved docs, which are recovered after crash:
+// edits are buffered in memory & appended to journal of session on worker thread in batches,
+// journal is emptied when no doc has unsaved edits & removed when session is finished
+class RecoveryJournal: public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RecoveryJournal(QObject *pParent = nullptr);
+    ~RecoveryJournal();
+
+    // position & removed chars count are given in chars of doc text
+    void appendEdit(const QString &fileName, int position, int charsRemoved, const QString &insertedText);
+    // earlier edits of file are not recovered anymore (doc was saved, reloaded or closed)
+    void markSaved(const QString &fileName);
+
+    // file name -> recovered text of every file which was left with unsaved edits
+    // by crashed session, journals of crashed sessions are removed
+    QHash<QString, QString> takeRecoveredContents();
+
+private slots:
+    void flush();
+
+private:
+    enum RecordType: quint8
+    {
+        BeginRecord,
+        EditRecord,
+        SavedRecord
+    };
+
+    // journal is created on the first edit, when application paths are already configured
+    bool ensureJournalOpened();
+    int getFileId(const QString &fileName);
+    void enqueueWrite(const QByteArray &data, bool truncate);
+    static QString getJournalsDir();
+    static void readJournal(const QString &journalFileName, QHash<QString, QString> &recoveredContents);
+
+    QString mJournalFileName;
+    // journal of running session is locked, so other instances don't recover it
+    std::unique_ptr<QLockFile> mpJournalLock;
+    bool mJournalFailed;
+    // records are written one after another by the only writer thread
+    QThreadPool mWriterPool;
+    QByteArray mBuffer;
+    QTimer mFlushTimer;
+
+    QHash<QString, int> mFileIds;
+    QSet<int> mUnsavedFiles;
+};
+
+#endif // RECOVERYJOURNAL_H
@@ -0,0 +1,75 @@
+#include "tabmemorymanager.h"
+
+#include "codeeditor.h"
+
+TabMemoryManager::TabMemoryManager(QObject *pParent):
+    QObject(pParent),
+    mMemoryBudget(DEFAULT_TABS_MEMORY_BUDGET_MB * 1024 * 1024),
+    mBlobsCount(0)
+{
+}
+
+void TabMemoryManager::setMemoryBudget(const qint64 bytes)
+{
+    mMemoryBudget = bytes;
+}
+
+qint64 TabMemoryManager::getMemoryBudget() const
+{
+    return mMemoryBudget;
+}
+
+void TabMemoryManager::touch(CodeEditor *doc)
+{
+    if (!mRecentDocs.removeOne(doc))
+    {
+        // doc is forgotten when it's closed
+        connect(doc, &QObject::destroyed, this, [this, doc]()
+        {
+            mRecentDocs.removeOne(doc);
+        });
+    }
+    mRecentDocs.prepend(doc);
+    doc->ensureContentLoaded();
+}
+
+void TabMemoryManager::enforceBudget(const QSet<CodeEditor*> &shownDocs)
+{
+    // blobs can't be written, so everything stays in memory
+    if (!mBlobsDir.isValid())
+    {
+        return;
+    }
+
+    qint64 residentSize = 0;
+    for (const auto &doc : mRecentDocs)
+    {
+        if (doc->isUnloaded())
+        {
+            continue;
+        }
+
+        const qint64 contentSize = doc->getContentSize();
+        if (residentSize + contentSize <= mMemoryBudget || !canBeUnloaded(doc, shownDocs))
+        {
+            residentSize += contentSize;
+            continue;
+        }
+
+        // if blob isn't written doc stays in memory
+        if (!doc->unloadContent(mBlobsDir.filePath(QString::number(++mBlobsCount))))
+        {
+            residentSize += contentSize;
+        }
+    }
+}
+
+bool TabMemoryManager::canBeUnloaded(CodeEditor *doc, const QSet<CodeEditor*> &shownDocs) const
+{
+    // only clean docs are unloaded, so content on disk is never the only copy of user's changes,
+    // doc shown in several views is used by all of them
+    return !shownDocs.contains(doc)
+            && !doc->isLoading()
+            && !doc->isChanged()
+            && doc->getViews().size() == 1;
+}
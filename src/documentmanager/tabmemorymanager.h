@@ -0,0 +1,40 @@
+#ifndef TABMEMORYMANAGER_H
+#define TABMEMORYMANAGER_H
+
+#include <QTemporaryDir>
+#include <QObject>
+#include <QList>
+#include <QSet>
+
+const qint64 DEFAULT_TABS_MEMORY_BUDGET_MB = 256;
+
+class CodeEditor;
+
+// keeps content of the most recently used docs in memory,
+// content of other clean docs is moved to blobs on disk & is restored on activation
+class TabMemoryManager: public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TabMemoryManager(QObject *pParent = nullptr);
+
+    void setMemoryBudget(const qint64 bytes);
+    qint64 getMemoryBudget() const;
+    // doc becomes the most recently used one, its content is restored if it was unloaded
+    void touch(CodeEditor *doc);
+    // least recently used docs are unloaded until the rest fits the budget,
+    // shown docs are never unloaded
+    void enforceBudget(const QSet<CodeEditor*> &shownDocs);
+
+private:
+    bool canBeUnloaded(CodeEditor *doc, const QSet<CodeEditor*> &shownDocs) const;
+
+    // the most recently used doc goes first
+    QList<CodeEditor*> mRecentDocs;
+    QTemporaryDir mBlobsDir;
+    qint64 mMemoryBudget;
+    int mBlobsCount;
+};
+
+#endif // TABMEMORYMANAGER_H
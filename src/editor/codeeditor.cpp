@@ -1,7 +1,9 @@
 #include "linenumberarea.h"
 #include "usermessages.h"
 #include "eventbuilder.h"
+#include "documentregistry.h"
 #include "filemanager.h"
+#include "textdiff.h"
 #include "codeeditor.h"
 #include "keywords.h"
 #include "utils.h"
@@ -19,17 +21,74 @@
 #include"methodspartsdefinitiongetters.h"
 #include"classgenerationliterals.h"
 #include<QMenu>
+#include<QDataStream>
+#include<QFile>
 #include <QVector>
+#include <QHash>
 
-CodeEditor::CodeEditor(QWidget *parent, const QString &fileName) : QPlainTextEdit(parent)
+namespace
+{
+// 64-bit FNV-1a over utf-16 code units, so any text is hashed without loss
+quint64 contentHash(const QString &text)
+{
+    quint64 rHash = 14695981039346656037ULL;
+    const ushort *pData = text.utf16();
+    for (int i = 0; i < text.size(); ++i)
+    {
+        rHash = (rHash ^ pData[i]) * 1099511628211ULL;
+    }
+    return rHash;
+}
+
+void writeHistory(QDataStream &stream, const ChangeManager &changeManager)
+{
+    stream << static_cast<quint32>(changeManager.mChangesHistory.size());
+    for (const auto &change : changeManager.mChangesHistory)
+    {
+        stream << static_cast<quint64>(change.beginChangePos)
+               << QByteArray::fromStdString(change.before)
+               << QByteArray::fromStdString(change.after);
+    }
+    stream << QByteArray::fromStdString(changeManager.mCurrentFileState);
+    // iterator of empty history doesn't point anywhere
+    stream << static_cast<qint32>(changeManager.mChangesHistory.empty()
+                                  ? -1
+                                  : changeManager.mCurrentFileStateIter - changeManager.mChangesHistory.begin());
+}
+
+void readHistory(QDataStream &stream, ChangeManager &changeManager)
+{
+    quint32 changesCount = 0;
+    stream >> changesCount;
+    for (quint32 i = 0; i < changesCount && stream.status() == QDataStream::Ok; ++i)
+    {
+        quint64 beginChangePos = 0;
+        QByteArray before;
+        QByteArray after;
+        stream >> beginChangePos >> before >> after;
+        changeManager.mChangesHistory.push_back(IntegralChange {static_cast<size_t>(beginChangePos),
+                                                                before.toStdString(),
+                                                                after.toStdString()});
+    }
+    QByteArray currentFileState;
+    qint32 currentFileStateIndex = -1;
+    stream >> currentFileState >> currentFileStateIndex;
+    changeManager.mCurrentFileState = currentFileState.toStdString();
+    if (currentFileStateIndex >= 0
+        && currentFileStateIndex < static_cast<qint32>(changeManager.mChangesHistory.size()))
+    {
+        changeManager.mCurrentFileStateIter = changeManager.mChangesHistory.begin() + currentFileStateIndex;
+    }
+}
+}
+
+CodeEditor::CodeEditor(QWidget *parent, const QString &fileName, CodeEditor *pDocumentView) : QPlainTextEdit(parent)
 {
     mFileName = fileName;
     setLineWrapMode(QPlainTextEdit::NoWrap);// don't move cursor to the next line where it's out of visible scope
     this->setVerticalScrollBarPolicy(Qt::ScrollBarPolicy::ScrollBarAlwaysOn);
     this->setTabStopDistance(TAB_SPACE * fontMetrics().width(QLatin1Char('0')));//set tab distance
     mCurrentZoom = 100;//in persents    
-    mLinesCount = 1;
-    mCode = document()->toPlainText();
     mCodeSize = 1;
     mHighlightingStart = 0;
     mStyle = mConfigParam.getIdeType();
@@ -42,12 +101,12 @@ CodeEditor::CodeEditor(QWidget *parent, const QString &fileName) : QPlainTextEdi
 
     //create objects connected to codeEditor
     mLineNumberArea = new LineNumberArea(this);
-    mTimer = new QTimer;
     mLcpp = new LexerCPP();
-    mTimer = new QTimer;
-    QVector<Token> firstLine;
-    mTokensList.append(firstLine);
-    mChangeManager = new ChangeManager(this->toPlainText().toUtf8().constData());
+    // timer runs only while there are changes which aren't written to history yet
+    mTimer = new QTimer(this);
+    mHighlightingPending = false;
+    mpDocRegistry = nullptr;
+    mViewPositionPending = false;
     //comment button
     mAddCommentButton = new AddCommentButton(this);
     mAddCommentButton->setText("+");
@@ -61,8 +120,27 @@ CodeEditor::CodeEditor(QWidget *parent, const QString &fileName) : QPlainTextEdi
 
     commentGetter = new CommentDb;
 
-    mStartComments = commentGetter->getAllCommentsFromFile(getFileName());
-    readAllCommentsFromDB(mStartComments);
+    if (pDocumentView)
+    {
+        // new view is attached to document of existing one, nothing is copied
+        mpState = pDocumentView->mpState;
+        setDocument(pDocumentView->document());
+    }
+    else
+    {
+        mpState = std::make_shared<DocumentState>();
+        mpState->mCode = document()->toPlainText();
+        QVector<Token> firstLine;
+        mpState->mTokensList.append(firstLine);
+        mpState->mpChangeManager.reset(new ChangeManager(this->toPlainText().toUtf8().constData()));
+        mpState->mpActiveView = this;
+
+        // comments are shown by primary view only
+        mStartComments = commentGetter->getAllCommentsFromFile(getFileName());
+        mSavedComments = mStartComments;
+        readAllCommentsFromDB(mStartComments);
+    }
+    mpState->mViews.append(this);
 
 
     //This signal is emitted when the text document needs an update of the specified rect.
@@ -80,8 +158,31 @@ CodeEditor::CodeEditor(QWidget *parent, const QString &fileName) : QPlainTextEdi
     connect(mCommentWidget->getEditTab(), &AddCommentTextEdit::notEmptyCommentWasSent,     this, &CodeEditor::notEmptyCommentWasAdded);
     connect(mCommentWidget->getEditTab(), &AddCommentTextEdit::commentWasDeleted,          this, &CodeEditor::deleteComment);
     connect(this,                         &CodeEditor::linesCountUpdated,                  this, &CodeEditor::changeCommentButtonsState);
+    if (!pDocumentView)
+    {
+        // document outlives its first view if other views show it, so it's connected to state itself
+        std::weak_ptr<DocumentState> wpState = mpState;
+        connect(document(), &QTextDocument::contentsChange, document(),
+                [wpState](int position, int charsRemoved, int charsAdded)
+        {
+            auto pState = wpState.lock();
+            // highlighting changes only formats of text
+            if (!pState || pState->mViews.isEmpty() || pState->mFormattingInProgress || !(charsRemoved || charsAdded))
+            {
+                return;
+            }
+            ++pState->mRevision;
+            CodeEditor *pPrimaryView = pState->mViews.front();
+            pPrimaryView->scheduleHistoryCapture();
 
-    mTimer->start(CHANGE_SAVE_TIME);//save text by this time
+            // content which is being loaded or restored is not an edit of user
+            if (!pState->mLoadingInProgress && !pState->mContentUnloaded)
+            {
+                emit pPrimaryView->contentEdited(position, charsRemoved,
+                                                 pPrimaryView->getText(position, charsAdded));
+            }
+        });
+    }
     mLinesCountCurrent = 1;
     mLinesCountPrev = 1;
 
@@ -113,8 +214,74 @@ CodeEditor::CodeEditor(QWidget *parent, const QString &fileName) : QPlainTextEdi
 
 CodeEditor::~CodeEditor()
 {
-    commentGetter->deleteCommentsFromDb(getFileName());
-    commentGetter->addCommentsToDb(getAllCommentsToDB());
+    const bool primaryView = isPrimaryView();
+    if (primaryView)
+    {
+        writeCommentsToDB();
+    }
+
+    mpState->mViews.removeOne(this);
+    if (mpState->mViews.isEmpty())
+    {
+        return;
+    }
+    if (mpState->mpActiveView == this)
+    {
+        mpState->mpActiveView = mpState->mViews.front();
+    }
+    if (primaryView)
+    {
+        mpState->mViews.front()->becomePrimaryView();
+    }
+}
+
+void CodeEditor::setDocumentRegistry(const DocumentRegistry *pDocRegistry)
+{
+    mpDocRegistry = pDocRegistry;
+}
+
+const QVector<CodeEditor*>& CodeEditor::getViews() const
+{
+    return mpState->mViews;
+}
+
+bool CodeEditor::isPrimaryView() const
+{
+    return mpState->mViews.front() == this;
+}
+
+CodeEditor* CodeEditor::activeView() const
+{
+    return mpState->mpActiveView;
+}
+
+void CodeEditor::becomePrimaryView()
+{
+    // document is owned by primary view, so it isn't destroyed with the previous one
+    document()->setParent(this);
+
+    // comments which were just written by previous primary view are shown here
+    mStartComments = commentGetter->getAllCommentsFromFile(getFileName());
+    mSavedComments = mStartComments;
+    readAllCommentsFromDB(mStartComments);
+    // lines count of this view is already tracked
+    mStartComments.clear();
+
+    // changes which previous primary view didn't write to history are written by this one
+    if (mpState->mRevision != mpState->mHistoryRevision)
+    {
+        scheduleHistoryCapture();
+    }
+}
+
+void CodeEditor::scheduleHistoryCapture()
+{
+    // partial or unloaded content isn't written to history
+    if (mpState->mLoadingInProgress || isUnloaded() || mTimer->isActive())
+    {
+        return;
+    }
+    mTimer->start(CHANGE_SAVE_TIME);//save text by this time
 }
 
 void CodeEditor::setTextColors()
@@ -153,27 +320,426 @@ void CodeEditor::writeDefinitionToSource()
         auto sourceFileName = removeExtension(getFileName(), headerExtension.length())//create source file path
                 .append(sourceExtension);
 
-        auto sourceFileText = fileManager.readFromFile(sourceFileName);//get content of this source file
+        auto sourceDocument = getOpenedDocument(sourceFileName);
+        //get content of this source file, unsaved changes of opened file have priority
+        auto sourceFileText = sourceDocument ? sourceDocument->toPlainText()
+                                             : fileManager.readFromFile(sourceFileName);
         if (!definitionExists(sourceFileText, this->textCursor()))//check if definition already exists
         {
-            auto sourceDocument =  getOpenedDocument(sourceFileName);
-            if (!sourceDocument)//if file is not opened
+            appendDefinitionsToSource(sourceFileName, sourceFileText, definitonTest);
+            QMessageBox::information(this, successDefinCreateTitle, successDefinCreateMessage);
+        }
+        else
+        {
+            QMessageBox::information(this, definitionExistsTitle, definitionExistsMessage);
+        }
+    }
+}
+
+void CodeEditor::writeAllDefinitionsToSource()
+{
+    FileManager fileManager;
+    if (!isFileWithExtension(getFileName(), "h")
+        || !fileManager.sourceFileByTheSameNameExists(getFileName()))
+    {
+        return;
+    }
+    auto sourceFileName = removeExtension(getFileName(), headerExtension.length())//create source file path
+            .append(sourceExtension);
+    auto sourceDocument = getOpenedDocument(sourceFileName);
+    auto sourceFileText = sourceDocument ? sourceDocument->toPlainText()
+                                         : fileManager.readFromFile(sourceFileName);
+
+    //compare the whole header with the source file in one pass
+    auto missingDefinitions = getMissingDefinitions(this->toPlainText(), sourceFileText);
+    if (missingDefinitions.isEmpty())
+    {
+        QMessageBox::information(this, definitionExistsTitle, allDefinsExistMessage);
+        return;
+    }
+    appendDefinitionsToSource(sourceFileName, sourceFileText, missingDefinitions.join("\n\n"));
+    QMessageBox::information(this, successDefinCreateTitle, successDefinsMessage);
+}
+
+void CodeEditor::appendDefinitionsToSource(const QString &sourceFileName, const QString &sourceFileText,
+                                           const QString &definitions)
+{
+    auto sourceDocument = getOpenedDocument(sourceFileName);
+    if (!sourceDocument)//if file is not opened
+    {
+        //write definitions to source file with one write and emit signal in order to open this file
+        FileManager().writeToFile(sourceFileName, sourceFileText + "\n" + definitions);
+        emit openDocument(sourceFileName);
+        return;
+    }
+    //append to the end of opened document as one undoable edit
+    QTextCursor cursor(sourceDocument->document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.beginEditBlock();
+    cursor.insertText("\n" + definitions);
+    cursor.endEditBlock();
+}
+
+void CodeEditor::applyReplacements(const QVector<TextReplacement> &replacements)
+{
+    if (replacements.isEmpty())
+    {
+        return;
+    }
+    const bool bulkEditInProgress = mpState->mBulkEditInProgress;
+    mpState->mBulkEditInProgress = true;
+    QTextCursor cursor(document());
+    cursor.beginEditBlock();
+    //replacements are applied from the end, so positions of the rest stay valid
+    for (auto it = replacements.crbegin(); it != replacements.crend(); ++it)
+    {
+        cursor.setPosition(it->mPosition);
+        cursor.setPosition(it->mPosition + it->mLength, QTextCursor::KeepAnchor);
+        cursor.insertText(it->mText);
+    }
+    cursor.endEditBlock();
+    mpState->mBulkEditInProgress = bulkEditInProgress;
+    if (!mpState->mLoadingInProgress)
+    {
+        relexDocument();
+    }
+}
+
+void CodeEditor::reloadContent(const QString &text)
+{
+    replaceContent(text);
+    setBeginTextState();
+}
+
+void CodeEditor::replaceContent(const QString &text)
+{
+    const QStringList oldLines = splitLines(toPlainText());
+    // lines of file with CRLF line breaks would differ from all lines of doc
+    const QStringList newLines = splitLines(normalizeLineBreaks(text));
+    const QVector<LineHunk> hunks = diffLines(oldLines, newLines);
+    if (hunks.isEmpty())
+    {
+        return;
+    }
+
+    // only changed lines are replaced, so cursors of views stay in place
+    QVector<TextReplacement> replacements;
+    int position = 0;
+    int oldLine = 0;
+    for (const auto &hunk : hunks)
+    {
+        for (; oldLine < hunk.mOldStart; ++oldLine)
+        {
+            position += oldLines[oldLine].size();
+        }
+        int length = 0;
+        for (; oldLine < hunk.mOldStart + hunk.mOldCount; ++oldLine)
+        {
+            length += oldLines[oldLine].size();
+        }
+        replacements.append(TextReplacement {position, length,
+                                              newLines.mid(hunk.mNewStart, hunk.mNewCount).join(QString())});
+        position += length;
+    }
+
+    const bool bulkEditInProgress = mpState->mBulkEditInProgress;
+    mpState->mBulkEditInProgress = true;
+    QTextCursor cursor(document());
+    cursor.beginEditBlock();
+    for (auto it = replacements.crbegin(); it != replacements.crend(); ++it)
+    {
+        cursor.setPosition(it->mPosition);
+        cursor.setPosition(it->mPosition + it->mLength, QTextCursor::KeepAnchor);
+        cursor.insertText(it->mText);
+    }
+    cursor.endEditBlock();
+    mpState->mBulkEditInProgress = bulkEditInProgress;
+
+    // tokens of unchanged lines are kept, changed lines are lexed again
+    auto &tokensList = mpState->mTokensList;
+    for (auto it = hunks.crbegin(); it != hunks.crend(); ++it)
+    {
+        for (int i = 0; i < it->mOldCount && it->mOldStart < tokensList.size(); ++i)
+        {
+            tokensList.removeAt(it->mOldStart);
+        }
+        for (int i = 0; i < it->mNewCount; ++i)
+        {
+            QString line = newLines[it->mNewStart + i];
+            if (line.endsWith(QChar('\n')))
             {
-                //write method definition to source file and emit signal in order to open this file
-                fileManager.writeToFile(sourceFileName, sourceFileText + "\n" + definitonTest);
-                emit openDocument(sourceFileName);
+                line.chop(1);
             }
-            else
+            mLcpp->clear();
+            mLcpp->lexicalAnalysis(line);
+            tokensList.insert(qMin(it->mOldStart + i, tokensList.size()), mLcpp->getTokens());
+        }
+    }
+    // the last empty line after '\n' isn't a separate line of diff
+    while (tokensList.size() > document()->blockCount())
+    {
+        tokensList.removeLast();
+    }
+    while (tokensList.size() < document()->blockCount())
+    {
+        tokensList.append(QVector<Token>());
+    }
+
+    for (const auto &view : getViews())
+    {
+        view->moveCommentButtons(hunks);
+    }
+
+    mpState->mLinesCount = static_cast<unsigned int>(document()->lineCount());
+    mpState->mCode = document()->toPlainText();
+    mHighlightingStart = static_cast<unsigned int>(hunks.front().mNewStart);
+    emit runHighlighter();
+}
+
+QString CodeEditor::getText(const int position, const int length) const
+{
+    // end of change reported for the whole document includes its last block separator
+    QTextCursor cursor(document());
+    cursor.setPosition(qBound(0, position, document()->characterCount() - 1));
+    cursor.setPosition(qBound(0, position + length, document()->characterCount() - 1), QTextCursor::KeepAnchor);
+    return cursor.selectedText().replace(QChar::ParagraphSeparator, QChar('\n'));
+}
+
+void CodeEditor::moveCommentButtons(const QVector<LineHunk> &hunks)
+{
+    for (auto &button : mCommentsVector)
+    {
+        // comment of changed line stays on the same line of hunk if it's still there
+        const int line = button->getCurrentLine() - 1;
+        int shift = 0;
+        int newLine = -1;
+        for (const auto &hunk : hunks)
+        {
+            if (line < hunk.mOldStart)
             {
-                 sourceDocument->setPlainText(sourceDocument->toPlainText() + "\n" + definitonTest);
+                break;
             }
-            QMessageBox::information(this, successDefinCreateTitle, successDefinCreateMessage);
+            if (line < hunk.mOldStart + hunk.mOldCount)
+            {
+                newLine = hunk.mNewStart + qMin(line - hunk.mOldStart, qMax(hunk.mNewCount - 1, 0));
+                break;
+            }
+            shift += hunk.mNewCount - hunk.mOldCount;
         }
-        else
+        button->setCurrentLine((newLine < 0 ? line + shift : newLine) + 1);
+    }
+
+    // lines count is changed by reload, so buttons aren't moved again when it's repainted
+    mLinesCountPrev = mLinesCountCurrent = document()->blockCount();
+}
+
+void CodeEditor::relexDocument()
+{
+    mpState->mTokensList.clear();
+    for (auto block = document()->begin(); block.isValid(); block = block.next())
+    {
+        mLcpp->clear();
+        mLcpp->lexicalAnalysis(block.text());
+        mpState->mTokensList.append(mLcpp->getTokens());
+    }
+    mpState->mLinesCount = static_cast<unsigned int>(document()->lineCount());
+    mpState->mCode = document()->toPlainText();
+    mHighlightingStart = 0;
+    emit runHighlighter();
+}
+
+void CodeEditor::moveCursorToLine(const int line)
+{
+    QTextBlock block = document()->findBlockByNumber(line - 1);
+    if (!block.isValid())
+    {
+        return;
+    }
+    setTextCursor(QTextCursor(block));
+    centerCursor();
+    setFocus();
+}
+
+void CodeEditor::beginLoading()
+{
+    // unloaded doc gets its content from loader,
+    // its view position is applied when content is read
+    mpState->mContentUnloaded = false;
+    mpState->mLoadingInProgress = true;
+    mpState->mEditedWhileLoading = false;
+    mpState->mBulkEditInProgress = true;
+    // partial states are not written to history
+    mTimer->stop();
+    setUndoRedoEnabled(false);
+}
+
+void CodeEditor::appendLoadedText(const QString &text)
+{
+    // chunk is added at the end, so user can work with already loaded part
+    QTextCursor cursor(document());
+    cursor.movePosition(QTextCursor::End);
+    mpState->mAppendingLoadedText = true;
+    cursor.insertText(text);
+    mpState->mAppendingLoadedText = false;
+}
+
+void CodeEditor::finishLoading()
+{
+    mpState->mLoadingInProgress = false;
+    mpState->mBulkEditInProgress = false;
+    setUndoRedoEnabled(true);
+    relexDocument();
+
+    mpState->mpChangeManager.reset(new ChangeManager(toPlainText().toUtf8().constData()));
+    mpState->mHistoryRevision = mpState->mRevision;
+
+    // edits made while loading keep document modified
+    if (!mpState->mEditedWhileLoading)
+    {
+        setBeginTextState();
+    }
+    applyPendingViewPosition();
+}
+
+bool CodeEditor::isLoading() const
+{
+    return mpState->mLoadingInProgress;
+}
+
+ViewPosition CodeEditor::getViewPosition() const
+{
+    // view of unloaded doc is empty, so position it had is returned
+    if (mViewPositionPending)
+    {
+        return mPendingViewPosition;
+    }
+    return ViewPosition {textCursor().position(), verticalScrollBar()->value(), horizontalScrollBar()->value()};
+}
+
+void CodeEditor::setViewPosition(const ViewPosition &position)
+{
+    QTextCursor cursor(document());
+    cursor.setPosition(qBound(0, position.mCursorPosition, document()->characterCount() - 1));
+    setTextCursor(cursor);
+    verticalScrollBar()->setValue(position.mVerticalScroll);
+    horizontalScrollBar()->setValue(position.mHorizontalScroll);
+}
+
+void CodeEditor::applyPendingViewPosition()
+{
+    if (mViewPositionPending)
+    {
+        mViewPositionPending = false;
+        setViewPosition(mPendingViewPosition);
+    }
+}
+
+qint64 CodeEditor::getContentSize() const
+{
+    return isUnloaded() ? 0 : static_cast<qint64>(document()->characterCount()) * CONTENT_BYTES_PER_CHAR;
+}
+
+bool CodeEditor::unloadContent(const QString &blobFileName)
+{
+    QByteArray blob;
+    QDataStream stream(&blob, QIODevice::WriteOnly);
+    stream << toPlainText();
+    writeHistory(stream, *mpState->mpChangeManager);
+
+    QFile blobFile(blobFileName);
+    if (!blobFile.open(QIODevice::WriteOnly) || blobFile.write(qCompress(blob)) == -1)
+    {
+        blobFile.remove();
+        return false;
+    }
+    blobFile.close();
+
+    setUnloaded(getViewPosition(), blobFileName);
+    return true;
+}
+
+void CodeEditor::setUnloaded(const ViewPosition &position, const QString &blobFileName)
+{
+    // outdated blob of already unloaded doc isn't needed anymore
+    if (hasContentBlob() && mpState->mBlobFileName != blobFileName)
+    {
+        QFile::remove(mpState->mBlobFileName);
+    }
+
+    // empty document isn't lexed & isn't written to history until content is restored
+    mPendingViewPosition = position;
+    mViewPositionPending = true;
+    mpState->mContentUnloaded = true;
+    mpState->mBlobFileName = blobFileName;
+    mpState->mBulkEditInProgress = true;
+    mTimer->stop();
+    document()->clear();
+    mpState->mTokensList.clear();
+    mpState->mCode.clear();
+    mpState->mpChangeManager.reset(new ChangeManager);
+}
+
+void CodeEditor::ensureContentLoaded()
+{
+    if (!isUnloaded())
+    {
+        return;
+    }
+
+    QString text;
+    std::unique_ptr<ChangeManager> pChangeManager(new ChangeManager);
+    bool contentRestored = false;
+    if (hasContentBlob())
+    {
+        QFile blobFile(mpState->mBlobFileName);
+        QByteArray blob;
+        if (blobFile.open(QIODevice::ReadOnly))
         {
-            QMessageBox::information(this, definitionExistsTitle, definitionExistsMessage);
+            blob = qUncompress(blobFile.readAll());
+            blobFile.close();
         }
+        blobFile.remove();
+
+        QDataStream stream(blob);
+        stream >> text;
+        readHistory(stream, *pChangeManager);
+        contentRestored = stream.status() == QDataStream::Ok;
     }
+    mpState->mBlobFileName.clear();
+
+    if (!contentRestored)
+    {
+        // unloaded doc was not modified, so its content is read from file if there is no blob
+        try
+        {
+            text = FileManager().readFromFile(getFileName());
+        }
+        catch (const FileOpeningFailure&)
+        {
+            text.clear();
+        }
+        pChangeManager.reset(new ChangeManager(text.toUtf8().constData()));
+    }
+
+    // restored content is not an edit, so doc becomes loaded only after it's set
+    document()->setPlainText(text);
+    mpState->mContentUnloaded = false;
+    mpState->mBulkEditInProgress = false;
+    relexDocument();
+    mpState->mpChangeManager = std::move(pChangeManager);
+    mpState->mHistoryRevision = mpState->mRevision;
+    setBeginTextState();
+    applyPendingViewPosition();
+}
+
+bool CodeEditor::isUnloaded() const
+{
+    return mpState->mContentUnloaded;
+}
+
+bool CodeEditor::hasContentBlob() const
+{
+    return !mpState->mBlobFileName.isEmpty();
 }
 
 QVector<Comment> CodeEditor::getStartComments() const
@@ -196,6 +762,13 @@ void CodeEditor::contextMenuEvent(QContextMenuEvent *event)
 
     addDefinitionAction->setEnabled(isValidMethodInitialization(this->textCursor()));
     connect(addDefinitionAction, &QAction::triggered, this, &CodeEditor::writeDefinitionToSource);
+
+    QAction *addAllDefinitionsAction = new QAction("Add all missing definitions", refactorItem);
+    refactorItem->addAction(addAllDefinitionsAction);
+
+    addAllDefinitionsAction->setEnabled(isFileWithExtension(getFileName(), "h")
+                                        && FileManager().sourceFileByTheSameNameExists(getFileName()));
+    connect(addAllDefinitionsAction, &QAction::triggered, this, &CodeEditor::writeAllDefinitionsToSource);
     menu->exec(event->globalPos());
 }
 
@@ -225,18 +798,18 @@ void CodeEditor::setConfigParam(const ConfigParams &configParam)
 
 void CodeEditor::handleLinesSwap(const int firstLine, const int secondLine)
 {
-    QVector<Token> tmp = mTokensList[firstLine];
-    mTokensList[firstLine] = mTokensList[secondLine];
-    mTokensList[secondLine] = tmp;
+    QVector<Token> tmp = mpState->mTokensList[firstLine];
+    mpState->mTokensList[firstLine] = mpState->mTokensList[secondLine];
+    mpState->mTokensList[secondLine] = tmp;
 }
 
 void CodeEditor::addToIdentifiersList(QStringList &identifiersName, int line)
 {
-    for (auto j = 0; j < mTokensList[line].size(); ++j)
+    for (auto j = 0; j < mpState->mTokensList[line].size(); ++j)
     {
-        if(mTokensList[line][j].mType == State::ID)
+        if(mpState->mTokensList[line][j].mType == State::ID)
         {
-            identifiersName << mTokensList[line][j].mName;
+            identifiersName << mpState->mTokensList[line][j].mName;
         }
     }
 }
@@ -248,7 +821,7 @@ void CodeEditor::handleLinesAddition(int changeStart, int lastLineWithChange, in
     if (lineDifference > 0)
     {
         changeStart = lastLineWithChange - lineDifference;
-        mTokensList.removeAt(changeStart);
+        mpState->mTokensList.removeAt(changeStart);
     }
 
     mHighlightingStart = changeStart > 0 ? changeStart - 1 : changeStart;
@@ -258,11 +831,11 @@ void CodeEditor::handleLinesAddition(int changeStart, int lastLineWithChange, in
         mLcpp->lexicalAnalysis(changedCode);
         if (lineDifference)
         {
-            mTokensList.insert(i, mLcpp->getTokens());
+            mpState->mTokensList.insert(i, mLcpp->getTokens());
         }
         else
         {
-            mTokensList[i] = mLcpp->getTokens();
+            mpState->mTokensList[i] = mLcpp->getTokens();
         }
     }
 }
@@ -275,11 +848,11 @@ void CodeEditor::handleLinesDelition(int lastLineWithChange, int lineDifference)
 
     mLcpp->lexicalAnalysis(changedCode);
     mHighlightingStart = lastLineWithChange;
-    mTokensList[lastLineWithChange] = mLcpp->getTokens();
+    mpState->mTokensList[lastLineWithChange] = mLcpp->getTokens();
 
     for (auto i = lastLineWithChange + 1; i < lastLineWithChange + lineDifference + 1; ++i)
     {
-        mTokensList.removeAt(lastLineWithChange + 1);
+        mpState->mTokensList.removeAt(lastLineWithChange + 1);
     }
 }
 
@@ -302,8 +875,8 @@ void CodeEditor::handleLineChange(int lastLineWithChange)
     int changeStart = lastLineWithChange;
 
     int currentLinesCount = document()->lineCount();
-    int lineDifference = currentLinesCount - mLinesCount;
-    mLinesCount = currentLinesCount;
+    int lineDifference = currentLinesCount - mpState->mLinesCount;
+    mpState->mLinesCount = currentLinesCount;
 
     if (!mLcpp->isLexerWasRunning())
     {
@@ -351,48 +924,81 @@ std::pair<const QString&, const QString&> CodeEditor::getChangedFileInfo()
 
 void CodeEditor::undo()
 {
-    QString text = QString::fromStdString(this->mChangeManager->undo());
+    if (mpState->mLoadingInProgress || isUnloaded())
+    {
+        return;
+    }
+    QString text = QString::fromStdString(this->mpState->mpChangeManager->undo());
     this->document()->setPlainText(text);
 
     QTextCursor cursor(this->document());
-    cursor.setPosition(mChangeManager->getCursorPosPrev());
+    cursor.setPosition(mpState->mpChangeManager->getCursorPosPrev());
 
     this->setTextCursor(cursor);
 }
 
 void CodeEditor::redo()
 {
-    QString text = QString::fromStdString(this->mChangeManager->redo());
+    if (mpState->mLoadingInProgress || isUnloaded())
+    {
+        return;
+    }
+    QString text = QString::fromStdString(this->mpState->mpChangeManager->redo());
     this->document()->setPlainText(text);
 
     QTextCursor cursor(this->document());
-    cursor.setPosition(mChangeManager->getCursorPosNext());
+    cursor.setPosition(mpState->mpChangeManager->getCursorPosNext());
 
     this->setTextCursor(cursor);
 }
 
 bool CodeEditor::isChanged()
 {
-    return mBeginTextState != QCryptographicHash::hash(this->toPlainText().toLatin1(),
-                                                       QCryptographicHash::Sha256);
+    // partially loaded document is never saved, unloaded one is clean
+    if (mpState->mLoadingInProgress || isUnloaded())
+    {
+        return false;
+    }
+    if (mpState->mRevision == mpState->mSavedRevision)
+    {
+        return false;
+    }
+    if (mpState->mRevision == mpState->mCheckedRevision)
+    {
+        return mpState->mChangedAtCheckedRevision;
+    }
+
+    // text could return to saved state (e.g. by undo), so content is compared
+    // with saved one, result is kept until the next change
+    const QString text = toPlainText();
+    mpState->mCheckedRevision = mpState->mRevision;
+    mpState->mChangedAtCheckedRevision = text.size() != mpState->mSavedLength || contentHash(text) != mpState->mSavedHash;
+    if (!mpState->mChangedAtCheckedRevision)
+    {
+        mpState->mSavedRevision = mpState->mRevision;
+    }
+    return mpState->mChangedAtCheckedRevision;
 }
 
 void CodeEditor::setBeginTextState()
 {
-    // when document is opened control sum is generated in order to have an opportunity
-    // to check whether document was modified
-    mBeginTextState = QCryptographicHash::hash(this->toPlainText().toLatin1(),
-                                               QCryptographicHash::Sha256);
+    // when document is opened or saved its content becomes saved state
+    // in order to have an opportunity to check whether document was modified
+    setSavedState(mpState->mRevision, toPlainText());
 }
 
-const QByteArray& CodeEditor::getBeginTextState() const
+quint64 CodeEditor::getRevision() const
 {
-    return  mBeginTextState;
+    return mpState->mRevision;
 }
 
-void CodeEditor::setTextState(const QByteArray &beginTextState)
+void CodeEditor::setSavedState(const quint64 revision, const QString &savedText)
 {
-    mBeginTextState = beginTextState;
+    // only hash of saved content is kept, not its copy
+    mpState->mSavedRevision = revision;
+    mpState->mSavedLength = savedText.size();
+    mpState->mSavedHash = contentHash(savedText);
+    mpState->mCheckedRevision = UNKNOWN_REVISION;
 }
 
 void CodeEditor::updateLineNumberAreaWidth()
@@ -472,8 +1078,15 @@ void CodeEditor::repaintButtonsArea(const int bottom, const int top, const int b
 
 void CodeEditor::saveStateInTheHistory()
 {
+    // nothing was changed since the last capture, so timer sleeps until the next change
+    if (mpState->mRevision == mpState->mHistoryRevision)
+    {
+        mTimer->stop();
+        return;
+    }
+    mpState->mHistoryRevision = mpState->mRevision;
     std::string newFileState = this->toPlainText().toUtf8().constData();
-    mChangeManager->writeChange(newFileState);
+    mpState->mpChangeManager->writeChange(newFileState);
 }
 
 void CodeEditor::zoom(const int val)
@@ -496,10 +1109,20 @@ void CodeEditor::setZoom(const int zoomVal)
 
 void CodeEditor::textChangedInTheOneLine()
 {
-    if (mCode != document()->toPlainText() || mStyle != mConfigParam.getIdeType())
+    if (mpState->mBulkEditInProgress)//document will be lexed once when bulk edit is finished
+    {
+        mpState->mEditedWhileLoading = mpState->mEditedWhileLoading || (mpState->mLoadingInProgress && !mpState->mAppendingLoadedText);
+        return;
+    }
+    // every view is notified about the change, it's lexed once by the view where it was made
+    if (activeView() != this)
+    {
+        return;
+    }
+    if (mpState->mCode != document()->toPlainText() || mStyle != mConfigParam.getIdeType())
     {
         mStyle = mConfigParam.getIdeType();
-        mCode = document()->toPlainText();
+        mpState->mCode = document()->toPlainText();
         emit textChangedInLine(this->textCursor().blockNumber());
     }
 }
@@ -531,17 +1154,13 @@ void CodeEditor::setNewAddedButtonSettings(AddCommentButton *commentButton)
 
 CodeEditor* CodeEditor::getOpenedDocument(const QString &fileName)
 {
-    auto allWidgets = QApplication::allWidgets();
-    for (auto widget: allWidgets)
+    auto rDoc = mpDocRegistry ? mpDocRegistry->findByPath(fileName) : nullptr;
+    if (rDoc)
     {
-        auto doc = qobject_cast<CodeEditor*>(widget);
-
-        if (doc && (doc->getFileName() == fileName))
-        {
-            return doc;
-        }
+        // content of unloaded doc is needed by caller
+        rDoc->ensureContentLoaded();
     }
-    return  nullptr;
+    return rDoc;
 }
 
 void CodeEditor::readAllCommentsFromDB(QVector<Comment> comments)
@@ -567,6 +1186,38 @@ QVector<Comment> CodeEditor::getAllCommentsToDB()
     return comments;
 }
 
+void CodeEditor::writeCommentsToDB()
+{
+    // comments read for previous name of file stay with that file
+    QHash<int, Comment> savedComments;
+    for (const auto &comment : mSavedComments)
+    {
+        if (comment.mFile == getFileName())
+        {
+            savedComments.insert(comment.mLine, comment);
+        }
+    }
+
+    const QVector<Comment> currentComments = getAllCommentsToDB();
+    QVector<Comment> changedComments;
+    for (const auto &comment : currentComments)
+    {
+        auto it = savedComments.find(comment.mLine);
+        if (it == savedComments.end() || it->mText != comment.mText || it->mUser != comment.mUser)
+        {
+            changedComments.push_back(comment);
+        }
+        if (it != savedComments.end())
+        {
+            savedComments.erase(it);
+        }
+    }
+
+    // comments are written in background, so doc is closed at once
+    commentGetter->writeCommentsChangesAsync(changedComments, savedComments.values().toVector());
+    mSavedComments = currentComments;
+}
+
 void CodeEditor::showCommentTextEdit(int line)
 {
     mCommentWidget->setPosition(this, mAddCommentButton);
@@ -634,7 +1285,7 @@ void CodeEditor::changeCommentButtonsState()
     }
 
     int diff = mLinesCountCurrent - mLinesCountPrev;//number that keeps the difference between previous and current lines count
-    int cursorLine = this->textCursor().blockNumber() + 1;//get the line where cursor is
+    int cursorLine = activeView()->textCursor().blockNumber() + 1;//get the line where cursor is
 
     //get the lines of start and end changing
     int startLine = diff > 0 ? cursorLine - diff : cursorLine;
@@ -662,7 +1313,7 @@ void CodeEditor::rewriteButtonsLines(QVector<AddCommentButton*> &commentV, const
     {
         if (i->getCurrentLine() == startLine)
         {
-            auto cursor = this->textCursor();
+            auto cursor = activeView()->textCursor();
             cursor.movePosition(QTextCursor::PreviousCharacter);
             //check if cursor was in the start of comment line.
             //that is the only one situation when we consider this line as the line where we should move comment button
@@ -744,7 +1395,7 @@ void CodeEditor::removeButtons(QVector<AddCommentButton*> &commentV, const int c
     {
         //if the last pressed remove button (delete or backspace) was delete we should check one more condition
         //because cursor position hasn't changed
-        if (lastRemomeKey == LastRemoveKey::DEL)
+        if (activeView()->getLastRemomeKey() == LastRemoveKey::DEL)
         {
             //this statment happens when we're staying above the line where comment is and pressed Delete.
             //we havn't moved the cursor position, but diff became -1 therefore we can't check this as usually
@@ -771,7 +1422,7 @@ void CodeEditor::removeButtons(QVector<AddCommentButton*> &commentV, const int c
 
 void CodeEditor::mouseMoveEvent(QMouseEvent *event)
 {
-    if (event->button() == Qt::NoButton)
+    if (event->button() == Qt::NoButton && isPrimaryView())
     {
         QTextBlock block = this->firstVisibleBlock();
 
@@ -820,7 +1471,8 @@ void CodeEditor::mouseMoveEvent(QMouseEvent *event)
 
 void CodeEditor::closeEvent(QCloseEvent *event)
 {
-    if (!isChanged())
+    // document stays opened in other views, so there is nothing to save
+    if (!isChanged() || getViews().size() > 1)
     {
         emit closeDocEventOccured(this);
         event->accept();
@@ -849,6 +1501,8 @@ void CodeEditor::closeEvent(QCloseEvent *event)
 
     try
     {
+        // saves which are still being written would replace this content
+        emit aboutToWriteFile(getFileName());
         FileManager().writeToFile(getFileName(), toPlainText());
         setBeginTextState();
     }
@@ -862,6 +1516,32 @@ void CodeEditor::closeEvent(QCloseEvent *event)
     emit closeDocEventOccured(this);
 }
 
+void CodeEditor::showEvent(QShowEvent *event)
+{
+    QPlainTextEdit::showEvent(event);
+    if (mHighlightingPending)
+    {
+        highlightText();
+    }
+}
+
+void CodeEditor::hideEvent(QHideEvent *event)
+{
+    // pending change is written to history at once, so hidden view doesn't keep timer running
+    if (mTimer->isActive())
+    {
+        saveStateInTheHistory();
+        mTimer->stop();
+    }
+    QPlainTextEdit::hideEvent(event);
+}
+
+void CodeEditor::focusInEvent(QFocusEvent *event)
+{
+    mpState->mpActiveView = this;
+    QPlainTextEdit::focusInEvent(event);
+}
+
 void formating(QTextCharFormat fmt, QTextCursor &cursor, Token token, int startingPosition)
 {
     cursor.setPosition(startingPosition + token.mBegin, QTextCursor::MoveAnchor);
@@ -871,6 +1551,16 @@ void formating(QTextCharFormat fmt, QTextCursor &cursor, Token token, int starti
 
 void CodeEditor::highlightText()
 {
+    // hidden view is highlighted when it's shown
+    if (!isVisible())
+    {
+        mHighlightingPending = true;
+        mHighlightingStart = 0;
+        return;
+    }
+    mHighlightingPending = false;
+    mpState->mFormattingInProgress = true;
+
     QTextBlock block = document()->findBlockByLineNumber(mHighlightingStart);
     QTextCursor cursor(block);
     int start = cursor.blockNumber();
@@ -884,26 +1574,26 @@ void CodeEditor::highlightText()
     // Highlight visible area
     for (auto i = start; i <= lastVisibleLine; ++i)
     {
-        if(i < mTokensList.size())
+        if(i < mpState->mTokensList.size())
         {
-            for(auto j = 0; j < mTokensList[i].size(); ++j)
+            for(auto j = 0; j < mpState->mTokensList[i].size(); ++j)
             {
-                switch(mTokensList[i][j].mType)
+                switch(mpState->mTokensList[i][j].mType)
                 {
                 case(State::KW):
-                    formating(fmtKeyword, cursor, mTokensList[i][j], startingPosition);
+                    formating(fmtKeyword, cursor, mpState->mTokensList[i][j], startingPosition);
                     break;
                 case(State::LIT):
-                    formating(fmtLiteral, cursor, mTokensList[i][j], startingPosition);
+                    formating(fmtLiteral, cursor, mpState->mTokensList[i][j], startingPosition);
                     break;
                 case(State::COM):
-                    formating(fmtComment, cursor, mTokensList[i][j], startingPosition);
+                    formating(fmtComment, cursor, mpState->mTokensList[i][j], startingPosition);
                     break;
                 case(State::UNDEF):
-                    formating(fmtUndefined, cursor, mTokensList[i][j], startingPosition);
+                    formating(fmtUndefined, cursor, mpState->mTokensList[i][j], startingPosition);
                     break;
                 default:
-                    formating(fmtRegular, cursor, mTokensList[i][j], startingPosition);
+                    formating(fmtRegular, cursor, mpState->mTokensList[i][j], startingPosition);
                     break;
                 }
             }
@@ -914,6 +1604,7 @@ void CodeEditor::highlightText()
         cursor.movePosition(QTextCursor::EndOfLine);
         startingPosition = cursor.position() + 1;
     }
+    mpState->mFormattingInProgress = false;
 }
 
 void CodeEditor::keyPressEvent(QKeyEvent *e)
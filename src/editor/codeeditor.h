@@ -4,6 +4,10 @@
 const int CHANGE_SAVE_TIME = 1000;
 const int TAB_SPACE = 4;
 const int TOP_UNUSED_PIXELS_HEIGHT = 4;
+// saved revision of document which was saved with content different from the current one
+const quint64 UNKNOWN_REVISION = ~quint64(0);
+// approximate memory taken by one char of document: text itself, its copies for lexer & history, tokens
+const int CONTENT_BYTES_PER_CHAR = 8;
 
 #include"ideconfiguration.h"
 #include"changemanager.h"
@@ -29,12 +33,15 @@ const int TOP_UNUSED_PIXELS_HEIGHT = 4;
 #include<QStringList>
 #include<QCompleter>
 #include"autocodecompleter.h"
+#include<memory>
 
 class QPaintEvent;
 class QResizeEvent;
 class QSize;
 class QWidget;
 class LineNumberArea;
+class DocumentRegistry;
+struct LineHunk;
 
 
 enum LastRemoveKey
@@ -43,11 +50,26 @@ enum LastRemoveKey
     DEL
 };
 
+struct ViewPosition
+{
+    int mCursorPosition;
+    int mVerticalScroll;
+    int mHorizontalScroll;
+};
+
+struct TextReplacement
+{
+    int mPosition;
+    int mLength;
+    QString mText;
+};
+
 class CodeEditor : public QPlainTextEdit
 {
     Q_OBJECT
 public:
-    CodeEditor(QWidget *parent = nullptr, const QString &fileName = "");
+    // if pDocumentView is passed, new view shows its document: text, tokens & history are shared
+    CodeEditor(QWidget *parent = nullptr, const QString &fileName = "", CodeEditor *pDocumentView = nullptr);
     virtual ~CodeEditor();
     void specialAreasRepaintEvent(QPaintEvent *event);
     void repaintButtonsArea(const int bottom, const int top, const int blockNumber);
@@ -60,8 +82,17 @@ public:
     void zoom(const int val);
     bool isChanged();
     void setBeginTextState();
-    const QByteArray& getBeginTextState()const;
-    void setTextState(const QByteArray &beginTextState);
+    // revision grows with every change of text
+    quint64 getRevision() const;
+    // savedText is content which was written to file when document had given revision
+    void setSavedState(const quint64 revision, const QString &savedText);
+
+    // opened docs are found through registry (e.g. source file for generated definitions)
+    void setDocumentRegistry(const DocumentRegistry *pDocRegistry);
+
+    // all views of document, the first one is primary: it keeps history & shows comments
+    const QVector<CodeEditor*>& getViews() const;
+    bool isPrimaryView() const;
 
     LastRemoveKey getLastRemomeKey() const;
     void setLastRemomeKey(const LastRemoveKey &value);
@@ -72,11 +103,47 @@ public:
     //DB methods
     void readAllCommentsFromDB(QVector<Comment> mStartComments);
     QVector<Comment> getAllCommentsToDB();
+    // only comments added, changed or removed since they were read or written last are written
+    void writeCommentsToDB();
 
     CommentDb *getCommentGetter() const;
 
     QVector<Comment> getStartComments() const;
 
+    // applies sorted non-overlapping replacements as one edit & lexes document once
+    void applyReplacements(const QVector<TextReplacement> &replacements);
+    void relexDocument();
+    // content is replaced by text changed outside (e.g. file was changed on disk)
+    // as minimal set of changed lines, tokens & comments of other lines are kept
+    void reloadContent(const QString &text);
+    // the same as reload, but doc stays modified (e.g. text of doc is recovered after crash)
+    void replaceContent(const QString &text);
+    // text of document in given range, line breaks are '\n'
+    QString getText(const int position, const int length) const;
+    // places cursor at the beginning of line (starts from 1)
+    void moveCursorToLine(const int line);
+
+    // content of file is appended by chunks while it's being loaded,
+    // document is lexed once when loading is finished
+    void beginLoading();
+    void appendLoadedText(const QString &text);
+    void finishLoading();
+    bool isLoading() const;
+
+    // cursor & scroll position, unloaded doc keeps position which is applied when content is read
+    ViewPosition getViewPosition() const;
+    void setViewPosition(const ViewPosition &position);
+
+    // content (text & history) of clean doc can be moved to blob file to free memory,
+    // doc keeps file name & comments and is restored when its content is needed again
+    qint64 getContentSize() const;
+    bool unloadContent(const QString &blobFileName);
+    // doc without blob is restored from its file (e.g. tab restored from session)
+    void setUnloaded(const ViewPosition &position, const QString &blobFileName = QString());
+    void ensureContentLoaded();
+    bool isUnloaded() const;
+    bool hasContentBlob() const;
+
 private:
     void rewriteButtonsLines(QVector<AddCommentButton*> &commentV, const int diff, const int startLine);
     void setAnotherButtonLine(AddCommentButton *comment, const int diff);
@@ -98,11 +165,23 @@ private:
     AddCommentButton* getCommentButtonByIndex(const int line);
     void setNewAddedButtonSettings(AddCommentButton *commentButton);
     CodeEditor* getOpenedDocument(const QString &fileName);
+    void appendDefinitionsToSource(const QString &sourceFileName, const QString &sourceFileText,
+                                   const QString &definitions);
+    // view which was edited last, lines changes are tracked by its cursor
+    CodeEditor* activeView() const;
+    void becomePrimaryView();
+    // history is captured by timer of primary view which runs only after changes
+    void scheduleHistoryCapture();
+    void applyPendingViewPosition();
+    void moveCommentButtons(const QVector<LineHunk> &hunks);
 
 protected:
     void resizeEvent(QResizeEvent *event)override;
     virtual void mouseMoveEvent(QMouseEvent *event) override;
     virtual void closeEvent(QCloseEvent *event) override;
+    virtual void focusInEvent(QFocusEvent *event) override;
+    virtual void showEvent(QShowEvent *event) override;
+    virtual void hideEvent(QHideEvent *event) override;
 
 private slots:
     void updateLineNumberAreaWidth();
@@ -126,6 +205,7 @@ public slots:
     void setFontStyle(const QString &fontStyle);
     void setIdeType(const QString &ideType);
     void writeDefinitionToSource();
+    void writeAllDefinitionsToSource();
 
 signals:
     void linesWasSwapped(int, int);
@@ -133,10 +213,14 @@ signals:
     void sendLexem(QString);
     void runHighlighter();
     void closeDocEventOccured(CodeEditor*);
+    // file of doc is going to be written directly (not by saver of document manager)
+    void aboutToWriteFile(const QString &fileName);
     void textChangedInLine(int);
     void textChangedInLines(int, int);
     void linesCountUpdated();
     void openDocument(const QString &);
+    // text of document was edited, is emitted by primary view once for all views
+    void contentEdited(int position, int charsRemoved, const QString &insertedText);
 
 private:
     QWidget *mLineNumberArea;
@@ -144,30 +228,32 @@ private:
     QFont mFont;
     LexerCPP *mLcpp;
     QString mFileName;
-    ChangeManager *mChangeManager;
     QTimer *mTimer;
     LexerCPP mLexer;
     AddCommentButton *mAddCommentButton;
     CommentWidget *mCommentWidget;
     QLabel *mCurrentCommentLable;
     QVector<Comment> mStartComments;
+    // comments as they're stored in DB
+    QVector<Comment> mSavedComments;
     QCompleter *mCompleter;
     QStringList completerKeywords;
     CommentDb *commentGetter;
     QSettings settings;
+    const DocumentRegistry *mpDocRegistry;
 
 
     QString mStyle;
     int mLinesCountPrev;
     int mLinesCountCurrent;
 
-    unsigned int mLinesCount;
     unsigned int mCodeSize;
-    QString mCode;
 
     unsigned int mHighlightingStart;
+    bool mHighlightingPending;
+    ViewPosition mPendingViewPosition;
+    bool mViewPositionPending;
 
-    QByteArray mBeginTextState;
     QVector<AddCommentButton*> mCommentsVector;
 
     QTextCharFormat fmtLiteral;
@@ -179,8 +265,43 @@ private:
     LastRemoveKey lastRemomeKey;
 
 protected:
+    // state of document which is shared by all its views
+    struct DocumentState
+    {
+        QVector<CodeEditor*> mViews;
+        CodeEditor *mpActiveView = nullptr;
+
+        QList<QVector<Token>> mTokensList;
+        std::unique_ptr<ChangeManager> mpChangeManager;
+        unsigned int mLinesCount = 1;
+        QString mCode;
+
+        // document is unchanged while its revision equals saved one,
+        // otherwise content is compared with saved one by length & hash
+        quint64 mRevision = 0;
+        // revision which was written to history last
+        quint64 mHistoryRevision = 0;
+        quint64 mSavedRevision = 0;
+        int mSavedLength = 0;
+        quint64 mSavedHash = 0;
+        // result of the last content comparison
+        quint64 mCheckedRevision = UNKNOWN_REVISION;
+        bool mChangedAtCheckedRevision = false;
+
+        bool mBulkEditInProgress = false;
+        // formats of text are changed by highlighting, content stays the same
+        bool mFormattingInProgress = false;
+        bool mLoadingInProgress = false;
+        bool mAppendingLoadedText = false;
+        bool mEditedWhileLoading = false;
+        // content is kept in blob file while doc is unloaded,
+        // if there is no blob content is read from file of doc
+        bool mContentUnloaded = false;
+        QString mBlobFileName;
+    };
+
     int mCurrentZoom;
-    QList<QVector<Token>> mTokensList;
+    std::shared_ptr<DocumentState> mpState;
     QList<QStringList> mIdentifiersList;
     QStringList mIdentifiersNameList;
     friend class Event;
@@ -69,5 +69,5 @@ int Event::editorCurrentZoom(CodeEditor *codeEditor)
 
 QList<QVector<Token>> Event::editorTokens(CodeEditor *codeEditor)
 {
-    return codeEditor->mTokensList;
+    return codeEditor->mpState->mTokensList;
 }
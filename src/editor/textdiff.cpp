@@ -0,0 +1,163 @@
+#include "textdiff.h"
+
+#include <vector>
+
+namespace
+{
+// marks lines which are removed from old text & added to new one,
+// returns false if texts differ more than MAX_DIFF_EDIT_DISTANCE
+bool markChangedLines(const QStringList &oldLines, int oldBegin, int oldEnd,
+                      const QStringList &newLines, int newBegin, int newEnd,
+                      std::vector<bool> &removed, std::vector<bool> &added)
+{
+    const int oldSize = oldEnd - oldBegin;
+    const int newSize = newEnd - newBegin;
+
+    // furthest x reached on every diagonal k (x - y) is kept for every edit distance d,
+    // diagonal k of distance d is stored at index k + d
+    std::vector<std::vector<int>> trace;
+    int distance = -1;
+    for (int d = 0; d <= MAX_DIFF_EDIT_DISTANCE && distance < 0; ++d)
+    {
+        std::vector<int> furthest(static_cast<size_t>(2 * d + 1));
+        for (int k = -d; k <= d; k += 2)
+        {
+            int x = 0;
+            if (d > 0)
+            {
+                const std::vector<int> &prev = trace.back();
+                const bool down = k == -d || (k != d && prev[k - 1 + d - 1] < prev[k + 1 + d - 1]);
+                x = down ? prev[k + 1 + d - 1] : prev[k - 1 + d - 1] + 1;
+            }
+            int y = x - k;
+            while (x < oldSize && y < newSize && oldLines[oldBegin + x] == newLines[newBegin + y])
+            {
+                ++x;
+                ++y;
+            }
+            furthest[k + d] = x;
+            if (x >= oldSize && y >= newSize)
+            {
+                distance = d;
+            }
+        }
+        trace.push_back(std::move(furthest));
+    }
+    if (distance < 0)
+    {
+        return false;
+    }
+
+    // path is followed back from the end, every step is one removed or added line
+    int x = oldSize;
+    int y = newSize;
+    for (int d = distance; d > 0; --d)
+    {
+        const std::vector<int> &prev = trace[d - 1];
+        const int k = x - y;
+        const bool down = k == -d || (k != d && prev[k - 1 + d - 1] < prev[k + 1 + d - 1]);
+        const int prevK = down ? k + 1 : k - 1;
+        const int prevX = prev[prevK + d - 1];
+        const int prevY = prevX - prevK;
+        if (down)
+        {
+            added[newBegin + prevY] = true;
+        }
+        else
+        {
+            removed[oldBegin + prevX] = true;
+        }
+        x = prevX;
+        y = prevY;
+    }
+    return true;
+}
+}
+
+QString normalizeLineBreaks(QString text)
+{
+    return text.replace(QString("\r\n"), QString("\n")).replace(QChar('\r'), QChar('\n'));
+}
+
+QStringList splitLines(const QString &text)
+{
+    QStringList rLines;
+    int lineStart = 0;
+    for (int i = 0; i < text.size(); ++i)
+    {
+        if (text[i] == QChar('\n'))
+        {
+            rLines.append(text.mid(lineStart, i + 1 - lineStart));
+            lineStart = i + 1;
+        }
+    }
+    if (lineStart < text.size())
+    {
+        rLines.append(text.mid(lineStart));
+    }
+    return rLines;
+}
+
+QVector<LineHunk> diffLines(const QStringList &oldLines, const QStringList &newLines)
+{
+    // common beginning & ending are skipped, only the rest is compared in detail
+    int oldBegin = 0;
+    int newBegin = 0;
+    while (oldBegin < oldLines.size() && newBegin < newLines.size() && oldLines[oldBegin] == newLines[newBegin])
+    {
+        ++oldBegin;
+        ++newBegin;
+    }
+    int oldEnd = oldLines.size();
+    int newEnd = newLines.size();
+    while (oldEnd > oldBegin && newEnd > newBegin && oldLines[oldEnd - 1] == newLines[newEnd - 1])
+    {
+        --oldEnd;
+        --newEnd;
+    }
+
+    QVector<LineHunk> rHunks;
+    if (oldBegin == oldEnd && newBegin == newEnd)
+    {
+        return rHunks;
+    }
+
+    std::vector<bool> removed(static_cast<size_t>(oldLines.size()), false);
+    std::vector<bool> added(static_cast<size_t>(newLines.size()), false);
+    if (!markChangedLines(oldLines, oldBegin, oldEnd, newLines, newBegin, newEnd, removed, added))
+    {
+        rHunks.append(LineHunk {oldBegin, oldEnd - oldBegin, newBegin, newEnd - newBegin});
+        return rHunks;
+    }
+
+    // unchanged lines go in the same order in both texts,
+    // so changed lines between them form hunks
+    int oldLine = oldBegin;
+    int newLine = newBegin;
+    while (oldLine < oldEnd || newLine < newEnd)
+    {
+        if (oldLine < oldEnd && newLine < newEnd && !removed[oldLine] && !added[newLine])
+        {
+            ++oldLine;
+            ++newLine;
+            continue;
+        }
+
+        LineHunk hunk {oldLine, 0, newLine, 0};
+        while ((oldLine < oldEnd && removed[oldLine]) || (newLine < newEnd && added[newLine]))
+        {
+            if (oldLine < oldEnd && removed[oldLine])
+            {
+                ++oldLine;
+                ++hunk.mOldCount;
+            }
+            else
+            {
+                ++newLine;
+                ++hunk.mNewCount;
+            }
+        }
+        rHunks.append(hunk);
+    }
+    return rHunks;
+}
@@ -0,0 +1,28 @@
+#ifndef TEXTDIFF_H
+#define TEXTDIFF_H
+
+#include <QStringList>
+#include <QVector>
+
+// lines which are compared in detail, if texts differ more -
+// the whole differing part is replaced by one hunk
+const int MAX_DIFF_EDIT_DISTANCE = 1000;
+
+// lines [mOldStart, mOldStart + mOldCount) of old text are replaced
+// by lines [mNewStart, mNewStart + mNewCount) of new text
+struct LineHunk
+{
+    int mOldStart;
+    int mOldCount;
+    int mNewStart;
+    int mNewCount;
+};
+
+// "\r\n" & '\r' are replaced by '\n', as doc contains only it (e.g. text read from file)
+QString normalizeLineBreaks(QString text);
+// every line keeps its '\n', so joined lines are equal to the text
+QStringList splitLines(const QString &text);
+// minimal set of changed lines (Myers diff), hunks are sorted & don't overlap
+QVector<LineHunk> diffLines(const QStringList &oldLines, const QStringList &newLines);
+
+#endif // TEXTDIFF_H
@@ -0,0 +1,137 @@
+#include "asyncfileloader.h"
+
+#include <QTextCodec>
+#include <QRunnable>
+#include <QThread>
+#include <QFile>
+
+#include "utils.h"
+
+class FileLoadTask: public QRunnable
+{
+public:
+    FileLoadTask(AsyncFileLoader *pLoader, const std::shared_ptr<FileLoadState> &pState,
+                 const QString &fileName):
+        mpLoader(pLoader), mpState(pState), mFileName(fileName)
+    {
+    }
+
+    void run() override
+    {
+        QFile file(mFileName);
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            emit mpLoader->loadingFailed();
+            return;
+        }
+
+        const qint64 size = file.size();
+        qint64 readSize = 0;
+        int lastPercent = -1;
+        std::unique_ptr<QTextDecoder> pDecoder;
+        // '\r' at the end of chunk can be the first half of "\r\n", so it's sent with the next chunk
+        QString pendingText;
+
+        while (!file.atEnd() && !mpState->mCancelled)
+        {
+            // gui thread is not flooded with chunks it can't append in time
+            while (mpState->mPendingChunks >= FILE_LOAD_MAX_PENDING_CHUNKS && !mpState->mCancelled)
+            {
+                QThread::msleep(1);
+            }
+
+            const QByteArray bytes = file.read(pDecoder ? FILE_LOAD_CHUNK_SIZE : FILE_LOAD_FIRST_CHUNK_SIZE);
+            if (bytes.isEmpty() && file.error() != QFile::NoError)
+            {
+                emit mpLoader->loadingFailed();
+                return;
+            }
+
+            // codec is chosen by byte order mark like QTextStream does,
+            // decoder keeps multibyte characters split between chunks
+            if (!pDecoder)
+            {
+                pDecoder.reset(QTextCodec::codecForUtfText(bytes, QTextCodec::codecForLocale())->makeDecoder());
+            }
+            QString text = pendingText + pDecoder->toUnicode(bytes);
+            pendingText.clear();
+            readSize += bytes.size();
+            if (text.endsWith(QChar('\r')) && !file.atEnd())
+            {
+                pendingText = text.right(1);
+                text.chop(1);
+            }
+
+            if (!text.isEmpty())
+            {
+                ++mpState->mPendingChunks;
+                emit mpLoader->chunkLoaded(text);
+            }
+
+            const int percent = size ? static_cast<int>(readSize * 100 / size) : 100;
+            if (percent != lastPercent)
+            {
+                lastPercent = percent;
+                emit mpLoader->progressChanged(percent);
+            }
+        }
+
+        if (!mpState->mCancelled)
+        {
+            if (!pendingText.isEmpty())
+            {
+                ++mpState->mPendingChunks;
+                emit mpLoader->chunkLoaded(pendingText);
+            }
+            emit mpLoader->loadingFinished();
+        }
+    }
+
+private:
+    AsyncFileLoader *mpLoader;
+    std::shared_ptr<FileLoadState> mpState;
+    QString mFileName;
+};
+
+AsyncFileLoader::AsyncFileLoader(QObject *pParent):
+    QObject (pParent)
+{
+    mThreadPool.setMaxThreadCount(1);
+}
+
+AsyncFileLoader::~AsyncFileLoader()
+{
+    cancel();
+    mThreadPool.waitForDone();
+}
+
+void AsyncFileLoader::start(const QString &fileName)
+{
+    // file is checked on the calling thread, so caller learns about failure at once
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        throw FileOpeningFailure();
+    }
+    file.close();
+
+    cancel();
+    mpState = std::make_shared<FileLoadState>();
+    mThreadPool.start(new FileLoadTask(this, mpState, fileName));
+}
+
+void AsyncFileLoader::cancel()
+{
+    if (mpState)
+    {
+        mpState->mCancelled = true;
+    }
+}
+
+void AsyncFileLoader::chunkProcessed()
+{
+    if (mpState)
+    {
+        --mpState->mPendingChunks;
+    }
+}
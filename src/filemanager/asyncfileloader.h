@@ -0,0 +1,50 @@
+#ifndef ASYNCFILELOADER_H
+#define ASYNCFILELOADER_H
+
+#include <QThreadPool>
+#include <QObject>
+#include <atomic>
+#include <memory>
+
+// the first chunk is small so that the first screen is shown at once
+const qint64 FILE_LOAD_FIRST_CHUNK_SIZE = 16 * 1024;
+const qint64 FILE_LOAD_CHUNK_SIZE = 512 * 1024;
+// reading is paused while gui thread has this number of chunks to append
+const int FILE_LOAD_MAX_PENDING_CHUNKS = 2;
+
+// state shared by loader & its reading task
+struct FileLoadState
+{
+    std::atomic<bool> mCancelled {false};
+    std::atomic<int> mPendingChunks {0};
+};
+
+// reads & decodes file on the worker thread, decoded text is delivered by chunks
+class AsyncFileLoader: public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AsyncFileLoader(QObject *pParent = nullptr);
+    ~AsyncFileLoader();
+
+    // throws FileOpeningFailure if file can't be opened for reading
+    void start(const QString &fileName);
+    void cancel();
+    // must be called when received chunk is processed
+    void chunkProcessed();
+
+signals:
+    void chunkLoaded(QString text);
+    void progressChanged(int percent);
+    void loadingFinished();
+    void loadingFailed();
+
+private:
+    friend class FileLoadTask;
+
+    QThreadPool mThreadPool;
+    std::shared_ptr<FileLoadState> mpState;
+};
+
+#endif // ASYNCFILELOADER_H
@@ -0,0 +1,138 @@
+#include "asyncfilesaver.h"
+
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+
+#include "filemanager.h"
+#include "utils.h"
+
+class FileSaveTask: public QRunnable
+{
+public:
+    FileSaveTask(AsyncFileSaver *pSaver, const int requestId,
+                 const QString &fileName, const QString &content):
+        mpSaver(pSaver), mRequestId(requestId), mFileName(fileName), mContent(content)
+    {
+    }
+
+    void run() override
+    {
+        bool success = true;
+        try
+        {
+            // content is encoded & written to temporary file which then replaces target
+            FileManager().writeToFile(mFileName, mContent);
+        }
+        catch (const FileOpeningFailure&)
+        {
+            success = false;
+        }
+        mpSaver->addResult(AsyncFileSaver::SaveResult {mRequestId, mFileName, success});
+    }
+
+private:
+    AsyncFileSaver *mpSaver;
+    int mRequestId;
+    QString mFileName;
+    QString mContent;
+};
+
+AsyncFileSaver::AsyncFileSaver(QObject *pParent):
+    QObject (pParent),
+    mLastRequestId(0)
+{
+    mThreadPool.setMaxThreadCount(qMax(2, QThread::idealThreadCount()));
+}
+
+AsyncFileSaver::~AsyncFileSaver()
+{
+    // started saves are finished, so no file is left half written
+    mThreadPool.waitForDone();
+}
+
+int AsyncFileSaver::save(const QString &fileName, const QString &content)
+{
+    SaveRequest request {++mLastRequestId, fileName, content};
+
+    // newer content of file is written only after the previous write is finished
+    if (mFilesInProgress.contains(fileName))
+    {
+        mQueuedRequests[fileName].push_back(request);
+    }
+    else
+    {
+        startSave(request);
+    }
+    return request.mId;
+}
+
+void AsyncFileSaver::waitForDone()
+{
+    // finishing of save can start the queued one
+    do
+    {
+        mThreadPool.waitForDone();
+        processResults();
+    }
+    while (!mFilesInProgress.isEmpty());
+}
+
+void AsyncFileSaver::waitForFile(const QString &fileName)
+{
+    // queued saves of file are started when previous ones are reported
+    while (mFilesInProgress.contains(fileName))
+    {
+        {
+            QMutexLocker locker(&mResultsMutex);
+            while (mResults.isEmpty())
+            {
+                mResultAdded.wait(&mResultsMutex);
+            }
+        }
+        processResults();
+    }
+}
+
+void AsyncFileSaver::startSave(const SaveRequest &request)
+{
+    mFilesInProgress.insert(request.mFileName);
+    mThreadPool.start(new FileSaveTask(this, request.mId, request.mFileName, request.mContent));
+}
+
+void AsyncFileSaver::addResult(const SaveResult &result)
+{
+    {
+        QMutexLocker locker(&mResultsMutex);
+        mResults.push_back(result);
+        mResultAdded.wakeAll();
+    }
+    QMetaObject::invokeMethod(this, "processResults", Qt::QueuedConnection);
+}
+
+void AsyncFileSaver::processResults()
+{
+    QVector<SaveResult> results;
+    {
+        QMutexLocker locker(&mResultsMutex);
+        results.swap(mResults);
+    }
+
+    for (const auto &result : results)
+    {
+        mFilesInProgress.remove(result.mFileName);
+
+        // next save of the same file can be started now
+        auto queuedIter = mQueuedRequests.find(result.mFileName);
+        if (queuedIter != mQueuedRequests.end())
+        {
+            SaveRequest request = queuedIter.value().takeFirst();
+            if (queuedIter.value().isEmpty())
+            {
+                mQueuedRequests.erase(queuedIter);
+            }
+            startSave(request);
+        }
+        emit saveFinished(result.mId, result.mFileName, result.mSuccess);
+    }
+}
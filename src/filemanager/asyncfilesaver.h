@@ -0,0 +1,69 @@
+#ifndef ASYNCFILESAVER_H
+#define ASYNCFILESAVER_H
+
+#include <QWaitCondition>
+#include <QThreadPool>
+#include <QObject>
+#include <QVector>
+#include <QMutex>
+#include <QHash>
+#include <QSet>
+
+// writes files on the worker pool, every file is replaced atomically
+// & saves of the same file are performed one after another in the order of requests
+class AsyncFileSaver: public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AsyncFileSaver(QObject *pParent = nullptr);
+    ~AsyncFileSaver();
+
+    // returns id of request which is passed back with saveFinished
+    int save(const QString &fileName, const QString &content);
+    // blocks until every requested save is finished & reported
+    void waitForDone();
+    // blocks until every requested save of file is finished & reported,
+    // so file can be written directly without being overwritten by older snapshot
+    void waitForFile(const QString &fileName);
+
+signals:
+    void saveFinished(int requestId, const QString &fileName, bool success);
+
+private:
+    friend class FileSaveTask;
+
+    struct SaveRequest
+    {
+        int mId;
+        QString mFileName;
+        QString mContent;
+    };
+
+    struct SaveResult
+    {
+        int mId;
+        QString mFileName;
+        bool mSuccess;
+    };
+
+    QThreadPool mThreadPool;
+    int mLastRequestId;
+
+    // accessed only from the gui thread
+    QSet<QString> mFilesInProgress;
+    QHash<QString, QVector<SaveRequest>> mQueuedRequests;
+
+    // filled by worker threads
+    QMutex mResultsMutex;
+    QWaitCondition mResultAdded;
+    QVector<SaveResult> mResults;
+
+    void startSave(const SaveRequest &request);
+    void addResult(const SaveResult &result);
+
+private slots:
+    void processResults();
+};
+
+#endif // ASYNCFILESAVER_H
@@ -1,6 +1,7 @@
 #include "filemanager.h"
 
 #include <QTextStream>
+#include <QSaveFile>
 #include <QFile>
 #include <QDir>
 #include "methodspartsdefinitiongetters.h"
@@ -44,13 +45,19 @@ void FileManager::createFile(const QString &fileName)
 void FileManager::writeToFile(const QString &fileName,
                              const QString &content)
 {
-    QFile file(fileName);
+    // content is written to temporary file which replaces target only when
+    // everything is written, so failed write never leaves target truncated
+    QSaveFile file(fileName);
 
     if (file.open(QIODevice::WriteOnly))
     {
-        QTextStream(&file) << content;
-        file.close();
-        return;
+        QTextStream stream(&file);
+        stream << content;
+        stream.flush();
+        if (file.commit())
+        {
+            return;
+        }
     }
     throw FileOpeningFailure();
 }
@@ -2,7 +2,11 @@ DEPENDPATH += $$PWD
 INCLUDEPATH += $$PWD
 
 HEADERS += \
-    $$PWD/filemanager.h
+    $$PWD/filemanager.h \
+    $$PWD/asyncfileloader.h \
+    $$PWD/asyncfilesaver.h
 
 SOURCES += \
-    $$PWD/filemanager.cpp
+    $$PWD/filemanager.cpp \
+    $$PWD/asyncfileloader.cpp \
+    $$PWD/asyncfilesaver.cpp
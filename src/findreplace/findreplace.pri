@@ -0,0 +1,10 @@
+DEPENDPATH += $$PWD
+INCLUDEPATH += $$PWD
+
+HEADERS += \
+    $$PWD/findreplacedialog.h \
+    $$PWD/searchengine.h
+
+SOURCES += \
+    $$PWD/findreplacedialog.cpp \
+    $$PWD/searchengine.cpp
@@ -0,0 +1,335 @@
+#include "findreplacedialog.h"
+
+#include <QTextDocument>
+#include <QPushButton>
+#include <QGridLayout>
+#include <QBoxLayout>
+#include <QScrollBar>
+#include <QTextBlock>
+#include <QCheckBox>
+#include <QLineEdit>
+#include <QLabel>
+
+#include "codeeditor.h"
+
+FindReplaceDialog::FindReplaceDialog(std::function<CodeEditor*()> editorProvider,
+                                     QWidget *pParent):
+    QDialog (pParent),
+    mEditorProvider(editorProvider),
+    mHighlightedFirstBlock(-1),
+    mHighlightedLastBlock(-1),
+    mHighlightedRevision(-1)
+{
+    setWindowTitle("Find/Replace");
+
+    // find & replace line edits
+    mpFindLine = new QLineEdit;
+    mpReplaceLine = new QLineEdit;
+    QGridLayout *pLinesLayout = new QGridLayout;
+    pLinesLayout->addWidget(new QLabel(tr("Find")), 0, 0);
+    pLinesLayout->addWidget(mpFindLine, 0, 1);
+    pLinesLayout->addWidget(new QLabel(tr("Replace")), 1, 0);
+    pLinesLayout->addWidget(mpReplaceLine, 1, 1);
+
+    // search modes
+    mpCaseSensitiveBox = new QCheckBox(tr("Match case"));
+    mpWholeWordsBox = new QCheckBox(tr("Whole words"));
+    mpRegexBox = new QCheckBox(tr("Regular expression"));
+    QHBoxLayout *pModesLayout = new QHBoxLayout;
+    pModesLayout->addWidget(mpCaseSensitiveBox);
+    pModesLayout->addWidget(mpWholeWordsBox);
+    pModesLayout->addWidget(mpRegexBox);
+    pModesLayout->addStretch(1);
+
+    // action buttons
+    QPushButton *pFindPrevBtn = new QPushButton(tr("Find Previous"));
+    QPushButton *pFindNextBtn = new QPushButton(tr("Find Next"));
+    QPushButton *pReplaceBtn = new QPushButton(tr("Replace"));
+    QPushButton *pReplaceAllBtn = new QPushButton(tr("Replace All"));
+    pFindNextBtn->setDefault(true);
+    QHBoxLayout *pButtonsLayout = new QHBoxLayout;
+    pButtonsLayout->addWidget(pFindPrevBtn);
+    pButtonsLayout->addWidget(pFindNextBtn);
+    pButtonsLayout->addWidget(pReplaceBtn);
+    pButtonsLayout->addWidget(pReplaceAllBtn);
+
+    mpStatusLbl = new QLabel;
+
+    // laying out window
+    QVBoxLayout *pWdwLayout = new QVBoxLayout;
+    pWdwLayout->addLayout(pLinesLayout);
+    pWdwLayout->addLayout(pModesLayout);
+    pWdwLayout->addLayout(pButtonsLayout);
+    pWdwLayout->addWidget(mpStatusLbl);
+    setLayout(pWdwLayout);
+
+    connect(pFindNextBtn, &QPushButton::clicked, this, &FindReplaceDialog::onFindNext);
+    connect(pFindPrevBtn, &QPushButton::clicked, this, &FindReplaceDialog::onFindPrevious);
+    connect(pReplaceBtn, &QPushButton::clicked, this, &FindReplaceDialog::onReplace);
+    connect(pReplaceAllBtn, &QPushButton::clicked, this, &FindReplaceDialog::onReplaceAll);
+    connect(mpFindLine, &QLineEdit::textChanged, this, &FindReplaceDialog::onSearchParametersChanged);
+    connect(mpCaseSensitiveBox, &QCheckBox::toggled, this, &FindReplaceDialog::onSearchParametersChanged);
+    connect(mpWholeWordsBox, &QCheckBox::toggled, this, &FindReplaceDialog::onSearchParametersChanged);
+    connect(mpRegexBox, &QCheckBox::toggled, this, &FindReplaceDialog::onSearchParametersChanged);
+}
+
+void FindReplaceDialog::start()
+{
+    // selected text becomes the pattern
+    auto pEditor = mEditorProvider();
+    if (pEditor && pEditor->textCursor().hasSelection())
+    {
+        mpFindLine->setText(pEditor->textCursor().selectedText());
+    }
+    show();
+    raise();
+    activateWindow();
+    mpFindLine->setFocus();
+    mpFindLine->selectAll();
+    prepareSearch();
+    highlightVisibleMatches();
+}
+
+bool FindReplaceDialog::prepareSearch()
+{
+    attachToEditor(mEditorProvider());
+    if (!mpEditor || !mSearchEngine.isValid())
+    {
+        return false;
+    }
+    return true;
+}
+
+void FindReplaceDialog::attachToEditor(CodeEditor *pEditor)
+{
+    if (pEditor == mpEditor)
+    {
+        return;
+    }
+
+    // highlighting is kept only on the document user works with
+    if (mpEditor)
+    {
+        clearHighlighting();
+        mpEditor->disconnect(this);
+    }
+    mpEditor = pEditor;
+    mHighlightedRevision = -1;
+
+    if (mpEditor)
+    {
+        // visible matches are refreshed on scrolling & editing
+        connect(mpEditor, &QPlainTextEdit::updateRequest, this, &FindReplaceDialog::highlightVisibleMatches);
+    }
+}
+
+bool FindReplaceDialog::findInDocument(bool backward)
+{
+    QTextDocument *pDocument = mpEditor->document();
+    QTextCursor cursor = mpEditor->textCursor();
+    QTextBlock block = cursor.block();
+
+    // blocks are scanned one by one starting from cursor, search wraps around document
+    for (int i = 0; i <= pDocument->blockCount(); ++i)
+    {
+        const QString text = block.text();
+        SearchMatch match;
+        if (backward)
+        {
+            int before = i ? text.size() : cursor.selectionStart() - block.position();
+            match = mSearchEngine.findPrevious(text, before);
+        }
+        else
+        {
+            int from = i ? 0 : cursor.selectionEnd() - block.position();
+            match = mSearchEngine.findNext(text, from);
+        }
+
+        if (match.isValid())
+        {
+            QTextCursor matchCursor(pDocument);
+            matchCursor.setPosition(block.position() + match.mPosition);
+            matchCursor.setPosition(block.position() + match.mPosition + match.mLength,
+                                    QTextCursor::KeepAnchor);
+            mpEditor->setTextCursor(matchCursor);
+            mpEditor->ensureCursorVisible();
+            return true;
+        }
+
+        block = backward ? block.previous() : block.next();
+        if (!block.isValid())
+        {
+            block = backward ? pDocument->lastBlock() : pDocument->firstBlock();
+        }
+    }
+    return false;
+}
+
+bool FindReplaceDialog::selectionIsMatch()
+{
+    QTextCursor cursor = mpEditor->textCursor();
+    if (!cursor.hasSelection())
+    {
+        return false;
+    }
+
+    QTextBlock block = mpEditor->document()->findBlock(cursor.selectionStart());
+    SearchMatch match = mSearchEngine.findNext(block.text(), cursor.selectionStart() - block.position());
+    return match.isValid()
+            && block.position() + match.mPosition == cursor.selectionStart()
+            && match.mLength == cursor.selectionEnd() - cursor.selectionStart();
+}
+
+void FindReplaceDialog::clearHighlighting()
+{
+    if (mpEditor)
+    {
+        mpEditor->setExtraSelections(QList<QTextEdit::ExtraSelection>());
+    }
+    mHighlightedFirstBlock = -1;
+    mHighlightedLastBlock = -1;
+    mHighlightedRevision = -1;
+}
+
+void FindReplaceDialog::onFindNext()
+{
+    if (!prepareSearch())
+    {
+        return;
+    }
+    mpStatusLbl->setText(findInDocument(false) ? QString() : tr("Nothing found"));
+}
+
+void FindReplaceDialog::onFindPrevious()
+{
+    if (!prepareSearch())
+    {
+        return;
+    }
+    mpStatusLbl->setText(findInDocument(true) ? QString() : tr("Nothing found"));
+}
+
+void FindReplaceDialog::onReplace()
+{
+    if (!prepareSearch())
+    {
+        return;
+    }
+
+    // selected match is replaced, then next one is selected
+    if (selectionIsMatch())
+    {
+        QTextCursor cursor = mpEditor->textCursor();
+        QTextBlock block = cursor.block();
+        SearchMatch match;
+        match.mPosition = cursor.selectionStart() - block.position();
+        match.mLength = cursor.selectionEnd() - cursor.selectionStart();
+        QString replacement = mSearchEngine.replacement(block.text(), match, mpReplaceLine->text());
+
+        cursor.beginEditBlock();
+        cursor.insertText(replacement);
+        cursor.endEditBlock();
+        mpEditor->setTextCursor(cursor);
+    }
+    onFindNext();
+}
+
+void FindReplaceDialog::onReplaceAll()
+{
+    if (!prepareSearch())
+    {
+        return;
+    }
+
+    // matches are collected block by block, then applied to the document at once
+    QVector<TextReplacement> replacements;
+    const QString replaceWith = mpReplaceLine->text();
+    for (QTextBlock block = mpEditor->document()->begin(); block.isValid(); block = block.next())
+    {
+        const QString text = block.text();
+        const auto matches = mSearchEngine.findAll(text);
+        for (const auto &match : matches)
+        {
+            replacements.push_back(TextReplacement {block.position() + match.mPosition,
+                                                    match.mLength,
+                                                    mSearchEngine.replacement(text, match, replaceWith)});
+        }
+    }
+
+    mpEditor->applyReplacements(replacements);
+    mpStatusLbl->setText(tr("%1 occurrence(s) replaced").arg(replacements.size()));
+}
+
+void FindReplaceDialog::onSearchParametersChanged()
+{
+    SearchOptions options;
+    options.mCaseSensitive = mpCaseSensitiveBox->isChecked();
+    options.mWholeWords = mpWholeWordsBox->isChecked();
+    options.mRegularExpression = mpRegexBox->isChecked();
+    mSearchEngine.setPattern(mpFindLine->text(), options);
+
+    bool invalidPattern = !mpFindLine->text().isEmpty() && !mSearchEngine.isValid();
+    mpStatusLbl->setText(invalidPattern ? tr("Invalid regular expression") : QString());
+
+    // pattern changed, so visible area has to be highlighted again
+    mHighlightedRevision = -1;
+    highlightVisibleMatches();
+}
+
+void FindReplaceDialog::highlightVisibleMatches()
+{
+    if (!mpEditor || !isVisible())
+    {
+        return;
+    }
+
+    // only blocks shown in viewport are searched
+    QTextBlock firstBlock = mpEditor->cursorForPosition(QPoint(0, 0)).block();
+    QTextBlock lastBlock = mpEditor->cursorForPosition(QPoint(mpEditor->viewport()->width() - 1,
+                                                              mpEditor->viewport()->height() - 1)).block();
+    int revision = mpEditor->document()->revision();
+
+    // setting extra selections causes repaint, which must not start highlighting again
+    if (firstBlock.blockNumber() == mHighlightedFirstBlock
+        && lastBlock.blockNumber() == mHighlightedLastBlock
+        && revision == mHighlightedRevision)
+    {
+        return;
+    }
+    mHighlightedFirstBlock = firstBlock.blockNumber();
+    mHighlightedLastBlock = lastBlock.blockNumber();
+    mHighlightedRevision = revision;
+
+    QList<QTextEdit::ExtraSelection> selections;
+    if (mSearchEngine.isValid())
+    {
+        QTextCharFormat matchFormat;
+        matchFormat.setBackground(QColor(Qt::yellow).lighter(140));
+
+        for (QTextBlock block = firstBlock; block.isValid(); block = block.next())
+        {
+            const auto matches = mSearchEngine.findAll(block.text());
+            for (const auto &match : matches)
+            {
+                QTextEdit::ExtraSelection selection;
+                selection.format = matchFormat;
+                selection.cursor = QTextCursor(mpEditor->document());
+                selection.cursor.setPosition(block.position() + match.mPosition);
+                selection.cursor.setPosition(block.position() + match.mPosition + match.mLength,
+                                             QTextCursor::KeepAnchor);
+                selections.push_back(selection);
+            }
+            if (block == lastBlock)
+            {
+                break;
+            }
+        }
+    }
+    mpEditor->setExtraSelections(selections);
+}
+
+void FindReplaceDialog::hideEvent(QHideEvent *event)
+{
+    clearHighlighting();
+    QDialog::hideEvent(event);
+}
@@ -0,0 +1,60 @@
+#ifndef FINDREPLACEDIALOG_H
+#define FINDREPLACEDIALOG_H
+
+#include <functional>
+#include <QPointer>
+#include <QDialog>
+
+#include "searchengine.h"
+
+class CodeEditor;
+class QCheckBox;
+class QLineEdit;
+class QLabel;
+
+// non-modal find & replace window which works with document in focus
+class FindReplaceDialog: public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit FindReplaceDialog(std::function<CodeEditor*()> editorProvider,
+                               QWidget *pParent = nullptr);
+    void start();
+
+private:
+    QLineEdit *mpFindLine;
+    QLineEdit *mpReplaceLine;
+    QCheckBox *mpCaseSensitiveBox;
+    QCheckBox *mpWholeWordsBox;
+    QCheckBox *mpRegexBox;
+    QLabel *mpStatusLbl;
+
+    SearchEngine mSearchEngine;
+    std::function<CodeEditor*()> mEditorProvider;
+    QPointer<CodeEditor> mpEditor;
+
+    // state of last highlighting is kept in order not to repeat it on every repaint
+    int mHighlightedFirstBlock;
+    int mHighlightedLastBlock;
+    int mHighlightedRevision;
+
+    bool prepareSearch();
+    void attachToEditor(CodeEditor *pEditor);
+    bool findInDocument(bool backward);
+    bool selectionIsMatch();
+    void clearHighlighting();
+
+private slots:
+    void onFindNext();
+    void onFindPrevious();
+    void onReplace();
+    void onReplaceAll();
+    void onSearchParametersChanged();
+    void highlightVisibleMatches();
+
+protected:
+    void hideEvent(QHideEvent *event) override;
+};
+
+#endif // FINDREPLACEDIALOG_H
@@ -0,0 +1,205 @@
+#include "searchengine.h"
+
+void SearchEngine::setPattern(const QString &pattern, const SearchOptions &options)
+{
+    mOptions = options;
+    mPattern.clear();
+    mRegex = QRegularExpression();
+
+    if (pattern.isEmpty())
+    {
+        return;
+    }
+
+    if (mOptions.mRegularExpression)
+    {
+        QString regexPattern = mOptions.mWholeWords ? "\\b(?:" + pattern + ")\\b" : pattern;
+        QRegularExpression::PatternOptions patternOptions = QRegularExpression::UseUnicodePropertiesOption;
+        if (!mOptions.mCaseSensitive)
+        {
+            patternOptions |= QRegularExpression::CaseInsensitiveOption;
+        }
+        mRegex = QRegularExpression(regexPattern, patternOptions);
+        // pattern is compiled here instead of on the first match
+        mRegex.optimize();
+        mPattern = pattern;
+        return;
+    }
+
+    // pattern is folded once, text symbols are folded while scanning
+    mPattern.reserve(pattern.size());
+    for (const auto &symbol : pattern)
+    {
+        mPattern.append(fold(symbol));
+    }
+
+    // bad character shift table is indexed by the low byte of utf-16 code unit
+    // symbols sharing the same low byte take the smallest shift, so no match is skipped
+    const int patternLength = mPattern.size();
+    mShiftTable.fill(patternLength);
+    for (int i = 0; i < patternLength - 1; ++i)
+    {
+        mShiftTable[mPattern[i].unicode() & 0xFF] = patternLength - 1 - i;
+    }
+}
+
+bool SearchEngine::isValid() const
+{
+    if (mPattern.isEmpty())
+    {
+        return false;
+    }
+    return !mOptions.mRegularExpression || mRegex.isValid();
+}
+
+QVector<SearchMatch> SearchEngine::findAll(const QString &text) const
+{
+    QVector<SearchMatch> rMatches;
+    if (!isValid())
+    {
+        return rMatches;
+    }
+
+    SearchMatch match = findNext(text);
+    while (match.isValid())
+    {
+        rMatches.push_back(match);
+        // empty regex matches must not stall the scan
+        match = findNext(text, match.mPosition + qMax(match.mLength, 1));
+    }
+    return rMatches;
+}
+
+SearchMatch SearchEngine::findNext(const QString &text, int from) const
+{
+    SearchMatch rMatch;
+    if (!isValid() || from > text.size())
+    {
+        return rMatch;
+    }
+
+    if (mOptions.mRegularExpression)
+    {
+        auto regexMatch = mRegex.match(text, from);
+        if (regexMatch.hasMatch())
+        {
+            rMatch.mPosition = regexMatch.capturedStart();
+            rMatch.mLength = regexMatch.capturedLength();
+        }
+        return rMatch;
+    }
+
+    int position = horspoolFind(text, from);
+    while (position >= 0)
+    {
+        if (!mOptions.mWholeWords || isWholeWord(text, position, mPattern.size()))
+        {
+            rMatch.mPosition = position;
+            rMatch.mLength = mPattern.size();
+            return rMatch;
+        }
+        position = horspoolFind(text, position + 1);
+    }
+    return rMatch;
+}
+
+SearchMatch SearchEngine::findPrevious(const QString &text, int before) const
+{
+    // blocks are short, so the last match before position is taken from forward scan
+    SearchMatch rMatch;
+    SearchMatch match = findNext(text);
+    while (match.isValid() && match.mPosition + match.mLength <= before)
+    {
+        rMatch = match;
+        match = findNext(text, match.mPosition + qMax(match.mLength, 1));
+    }
+    return rMatch;
+}
+
+QString SearchEngine::replacement(const QString &text, const SearchMatch &match,
+                                  const QString &replaceWith) const
+{
+    if (!mOptions.mRegularExpression)
+    {
+        return replaceWith;
+    }
+
+    auto regexMatch = mRegex.match(text, match.mPosition, QRegularExpression::NormalMatch,
+                                   QRegularExpression::AnchoredMatchOption);
+    if (!regexMatch.hasMatch())
+    {
+        return replaceWith;
+    }
+
+    // expand \0..\9 references to the captured groups
+    QString rReplacement;
+    rReplacement.reserve(replaceWith.size());
+    for (int i = 0; i < replaceWith.size(); ++i)
+    {
+        if (replaceWith[i] == '\\' && i + 1 < replaceWith.size() && replaceWith[i + 1].isDigit())
+        {
+            rReplacement.append(regexMatch.captured(replaceWith[i + 1].digitValue()));
+            ++i;
+            continue;
+        }
+        rReplacement.append(replaceWith[i]);
+    }
+    return rReplacement;
+}
+
+int SearchEngine::horspoolFind(const QString &text, int from) const
+{
+    const int patternLength = mPattern.size();
+    const int textLength = text.size();
+    const QChar *pText = text.constData();
+    const QChar *pPattern = mPattern.constData();
+    const QChar lastPatternSymbol = pPattern[patternLength - 1];
+
+    int position = from;
+    while (position <= textLength - patternLength)
+    {
+        // compare the last symbol first, it rejects most of windows
+        const QChar lastTextSymbol = fold(pText[position + patternLength - 1]);
+        if (lastTextSymbol == lastPatternSymbol)
+        {
+            int i = patternLength - 2;
+            while (i >= 0 && fold(pText[position + i]) == pPattern[i])
+            {
+                --i;
+            }
+            if (i < 0)
+            {
+                return position;
+            }
+        }
+        position += mShiftTable[lastTextSymbol.unicode() & 0xFF];
+    }
+    return -1;
+}
+
+bool SearchEngine::isWholeWord(const QString &text, int position, int length) const
+{
+    // match must not be surrounded by identifier symbols
+    int end = position + length;
+    return (position == 0 || !isWordCharacter(text[position - 1]))
+            && (end == text.size() || !isWordCharacter(text[end]));
+}
+
+bool SearchEngine::isWordCharacter(const QChar &symbol) const
+{
+    return symbol.isLetterOrNumber() || symbol == '_';
+}
+
+QChar SearchEngine::fold(const QChar &symbol) const
+{
+    if (mOptions.mCaseSensitive)
+    {
+        return symbol;
+    }
+    // ascii symbols are folded without unicode table lookup
+    if (symbol.unicode() < 0x80)
+    {
+        return (symbol >= 'A' && symbol <= 'Z') ? QChar(symbol.unicode() + ('a' - 'A')) : symbol;
+    }
+    return symbol.toCaseFolded();
+}
@@ -0,0 +1,59 @@
+#ifndef SEARCHENGINE_H
+#define SEARCHENGINE_H
+
+#include <QRegularExpression>
+#include <QString>
+#include <QVector>
+#include <array>
+
+const int SHIFT_TABLE_SIZE = 256;
+
+struct SearchMatch
+{
+    int mPosition = -1;// -1 means that nothing was found
+    int mLength = 0;
+
+    bool isValid() const
+    {
+        return mPosition >= 0;
+    }
+};
+
+struct SearchOptions
+{
+    bool mCaseSensitive = false;
+    bool mWholeWords = false;
+    bool mRegularExpression = false;
+};
+
+// searches pattern in a text of single block
+// plain patterns are searched with Boyer-Moore-Horspool algorithm,
+// regular expressions are compiled once per pattern
+class SearchEngine
+{
+public:
+    void setPattern(const QString &pattern, const SearchOptions &options);
+    bool isValid() const;
+
+    QVector<SearchMatch> findAll(const QString &text) const;
+    SearchMatch findNext(const QString &text, int from = 0) const;
+    SearchMatch findPrevious(const QString &text, int before) const;
+
+    // text which has to be placed instead of the match
+    // (captures like \1 are expanded for regular expressions)
+    QString replacement(const QString &text, const SearchMatch &match,
+                        const QString &replaceWith) const;
+
+private:
+    int horspoolFind(const QString &text, int from) const;
+    bool isWholeWord(const QString &text, int position, int length) const;
+    bool isWordCharacter(const QChar &symbol) const;
+    QChar fold(const QChar &symbol) const;
+
+    QString mPattern;
+    SearchOptions mOptions;
+    QRegularExpression mRegex;
+    std::array<int, SHIFT_TABLE_SIZE> mShiftTable;
+};
+
+#endif // SEARCHENGINE_H
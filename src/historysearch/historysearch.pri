@@ -0,0 +1,8 @@
+DEPENDPATH += $$PWD
+INCLUDEPATH += $$PWD
+
+HEADERS += \
+    $$PWD/historysearchwidget.h
+
+SOURCES += \
+    $$PWD/historysearchwidget.cpp
@@ -0,0 +1,113 @@
+#include "historysearchwidget.h"
+
+#include <QPushButton>
+#include <QListWidget>
+#include <QBoxLayout>
+#include <QLineEdit>
+#include <QFileInfo>
+#include <QLabel>
+
+#include "sqliteaccess.h"
+
+HistorySearchWidget::HistorySearchWidget(SearchScope scope, QWidget *pParent):
+    QWidget (pParent),
+    mScope(scope),
+    mHitsCount(0)
+{
+    mpSearchLine = new QLineEdit;
+    mpSearchLine->setPlaceholderText(scope == MessagesScope ? tr("Search in chat history")
+                                                            : tr("Search in comments"));
+    mpSearchLine->setClearButtonEnabled(true);
+    mpMoreBtn = new QPushButton(tr("More"));
+    mpMoreBtn->setEnabled(false);
+    mpStatusLbl = new QLabel;
+
+    QHBoxLayout *pControlsLayout = new QHBoxLayout;
+    pControlsLayout->addWidget(mpSearchLine, 1);
+    pControlsLayout->addWidget(mpMoreBtn);
+    pControlsLayout->addWidget(mpStatusLbl);
+
+    mpResultsList = new QListWidget;
+    mpResultsList->setUniformItemSizes(true);
+    mpResultsList->setWordWrap(false);
+    // results are shown only while there is something found
+    mpResultsList->setVisible(false);
+
+    QVBoxLayout *pLayout = new QVBoxLayout;
+    pLayout->setContentsMargins(0, 0, 0, 0);
+    pLayout->addLayout(pControlsLayout);
+    pLayout->addWidget(mpResultsList);
+    setLayout(pLayout);
+
+    connect(mpSearchLine, &QLineEdit::returnPressed, this, &HistorySearchWidget::onSearch);
+    connect(mpMoreBtn, &QPushButton::clicked, this, &HistorySearchWidget::onMore);
+    connect(mpResultsList, &QListWidget::itemActivated, this, &HistorySearchWidget::onResultActivated);
+}
+
+void HistorySearchWidget::focusSearchLine()
+{
+    mpSearchLine->setFocus();
+    mpSearchLine->selectAll();
+}
+
+void HistorySearchWidget::onSearch()
+{
+    mSearchText = mpSearchLine->text().trimmed();
+    mHitsCount = 0;
+    mpResultsList->clear();
+    mpStatusLbl->clear();
+    mpMoreBtn->setEnabled(false);
+    mpResultsList->setVisible(!mSearchText.isEmpty());
+    if (mSearchText.isEmpty())
+    {
+        return;
+    }
+    onMore();
+}
+
+void HistorySearchWidget::onMore()
+{
+    const bool hasMore = mScope == MessagesScope ? appendMessagesPage() : appendCommentsPage();
+    mpMoreBtn->setEnabled(hasMore);
+    mpStatusLbl->setText(tr("%1 match(es)%2").arg(mHitsCount).arg(hasMore ? "..." : ""));
+}
+
+bool HistorySearchWidget::appendMessagesPage()
+{
+    const QVector<Message> messages = MessageDb(ConnectionMode::ReadOnly).searchMessagesInDb(mSearchText, mHitsCount,
+                                                                     HISTORY_SEARCH_PAGE_SIZE);
+    for (const auto &message : messages)
+    {
+        mpResultsList->addItem(QString("[%1] %2: %3").arg(message.mTime, message.mUser,
+                                                          message.mBody.simplified()));
+    }
+    mHitsCount += messages.size();
+    return messages.size() == HISTORY_SEARCH_PAGE_SIZE;
+}
+
+bool HistorySearchWidget::appendCommentsPage()
+{
+    const QVector<Comment> comments = CommentDb(ConnectionMode::ReadOnly).searchCommentsInDb(mSearchText, mHitsCount,
+                                                                     HISTORY_SEARCH_PAGE_SIZE);
+    for (const auto &comment : comments)
+    {
+        QListWidgetItem *pItem = new QListWidgetItem(QString("%1:%2  %3: %4")
+                                                     .arg(QFileInfo(comment.mFile).fileName())
+                                                     .arg(comment.mLine)
+                                                     .arg(comment.mUser, comment.mText.simplified()));
+        pItem->setToolTip(comment.mFile);
+        pItem->setData(FileNameRole, comment.mFile);
+        pItem->setData(LineRole, comment.mLine);
+        mpResultsList->addItem(pItem);
+    }
+    mHitsCount += comments.size();
+    return comments.size() == HISTORY_SEARCH_PAGE_SIZE;
+}
+
+void HistorySearchWidget::onResultActivated(QListWidgetItem *pItem)
+{
+    if (mScope == CommentsScope)
+    {
+        emit openFileAtLine(pItem->data(FileNameRole).toString(), pItem->data(LineRole).toInt());
+    }
+}
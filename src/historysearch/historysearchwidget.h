@@ -0,0 +1,62 @@
+#ifndef HISTORYSEARCHWIDGET_H
+#define HISTORYSEARCHWIDGET_H
+
+#include <QWidget>
+
+class QListWidget;
+class QListWidgetItem;
+class QPushButton;
+class QLineEdit;
+class QLabel;
+
+// hits are read from DB by pages of this size
+const int HISTORY_SEARCH_PAGE_SIZE = 50;
+
+// full-text search in chat messages or code comments stored in DB,
+// hits are shown the most relevant first & the next page is read on demand
+class HistorySearchWidget: public QWidget
+{
+    Q_OBJECT
+
+public:
+    enum SearchScope
+    {
+        MessagesScope,
+        CommentsScope
+    };
+
+    explicit HistorySearchWidget(SearchScope scope, QWidget *pParent = nullptr);
+
+    void focusSearchLine();
+
+signals:
+    // is emitted when hit of comments search is activated
+    void openFileAtLine(const QString &fileName, int line);
+
+private:
+    enum HitRoles
+    {
+        FileNameRole = Qt::UserRole + 1,
+        LineRole
+    };
+
+    // hits are appended to list, true is returned when there can be more of them
+    bool appendMessagesPage();
+    bool appendCommentsPage();
+
+    SearchScope mScope;
+    QString mSearchText;
+    int mHitsCount;
+
+    QLineEdit *mpSearchLine;
+    QPushButton *mpMoreBtn;
+    QLabel *mpStatusLbl;
+    QListWidget *mpResultsList;
+
+private slots:
+    void onSearch();
+    void onMore();
+    void onResultActivated(QListWidgetItem *pItem);
+};
+
+#endif // HISTORYSEARCHWIDGET_H
@@ -18,6 +18,7 @@ int main(int argc, char *argv[])
     splashScreen.finish(&w);
 
     w.show();
+    w.recoverUnsavedDocuments();
     w.showStartPage();
 
     return a.exec();
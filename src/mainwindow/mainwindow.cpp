@@ -4,6 +4,8 @@
 #include <QListWidgetItem>
 #include <QMdiSubWindow>
 #include <QStyleFactory>
+#include <QProgressBar>
+#include <QPushButton>
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QSettings>
@@ -16,11 +18,15 @@
 #include "paletteconfigurator.h"
 #include "projectviewerdock.h"
 #include "newprojectwizard.h"
+#include "projectsearchwidget.h"
+#include "historysearchwidget.h"
+#include "findreplacedialog.h"
 #include "documentmanager.h"
 #include "bottompaneldock.h"
 #include "savefilesdialog.h"
 #include "classgenerator.h"
 #include "chatwindowdock.h"
+#include "quickopendialog.h"
 #include "newfilewizard.h"
 #include "usermessages.h"
 #include "logindialog.h"
@@ -39,7 +45,12 @@ MainWindow::MainWindow(QWidget *parent) :
     mpDocumentManager(new DocumentManager),
     // initializing palette configurator with current palette
     mpPaletteConfigurator(new PaletteConfigurator(palette())),
-    dbFileManager(new FileDb)
+    dbFileManager(new FileDb),
+    mpFindReplaceDialog(nullptr),
+    mpQuickOpenDialog(nullptr),
+    mpLoadingProgressBar(nullptr),
+    mpCancelLoadingBtn(nullptr),
+    mExternalChangesPromptShown(false)
 {
     // Generate default local network connector
     mplocalConnector =
@@ -78,6 +89,16 @@ MainWindow::MainWindow(QWidget *parent) :
     // create instance of Bottom Panel
     createButtomPanel();
 
+    createLoadingIndicator();
+
+    // results of saves which are performed in background
+    connect(mpDocumentManager.data(), &DocumentManager::documentSaved,
+            this, &MainWindow::onDocumentSaved);
+    connect(mpDocumentManager.data(), &DocumentManager::documentSavingFailed,
+            this, &MainWindow::onDocumentSavingFailed);
+    connect(mpDocumentManager.data(), &DocumentManager::documentsChangedExternally,
+            this, &MainWindow::onDocumentsChangedExternally);
+
     setInitialAppStyle();
     restoreMainWindowState();
 }
@@ -97,6 +118,25 @@ void MainWindow::showStartPage()
     startPage.showStartPage();
 }
 
+void MainWindow::recoverUnsavedDocuments()
+{
+    auto recoveredDocuments = mpDocumentManager->takeRecoveredDocuments();
+    if (recoveredDocuments.isEmpty())
+    {
+        return;
+    }
+
+    auto reply = QMessageBox::question
+            (this,
+             userMessages[UserMessages::UnsavedChangesRecoveredTitle],
+            userMessages[UserMessages::UnsavedChangesRecoveredMsg] + recoveredDocuments.keys().join("\n"));
+
+    if (reply == QMessageBox::Yes)
+    {
+        mpDocumentManager->openRecoveredDocuments(recoveredDocuments);
+    }
+}
+
 void MainWindow::setupMainMenu()
 {
     // file menu
@@ -124,6 +164,7 @@ void MainWindow::setupMainMenu()
     QAction *pOpenFileAction = fileMenu->addAction("&Open file...", this, &MainWindow::onOpenFileTriggered, Qt::CTRL + Qt::Key_O);
     pOpenFileAction->setIcon(QIcon(":/img/OPENFILE.png"));
     pToolbar->addAction(pOpenFileAction);
+    fileMenu->addAction("&Quick open...", this, &MainWindow::onQuickOpenTriggered, Qt::CTRL + Qt::Key_P);
     QAction *pOpenFolderAction = fileMenu->addAction("Open pro&ject...", this, &MainWindow::onOpenProjectTriggered);
     pOpenFolderAction->setIcon(QIcon(":/img/OPENDIR.png"));
     pToolbar->addAction(pOpenFolderAction);
@@ -162,8 +203,13 @@ void MainWindow::setupMainMenu()
     editMenu->addSeparator();
 
     // find patterns in docs
-    QAction *pFindAction = editMenu->addAction("&Find/Replace...", this, &MainWindow::onFindTriggered, Qt::CTRL + Qt::Key_F);
-    pFindAction->setDisabled(true);
+    editMenu->addAction("&Find/Replace...", this, &MainWindow::onFindTriggered, Qt::CTRL + Qt::Key_F);
+    editMenu->addAction("Find in &Project...", this, &MainWindow::onFindInProjectTriggered,
+                        Qt::CTRL + Qt::SHIFT + Qt::Key_F);
+    editMenu->addAction("Find in Co&mments...", this, &MainWindow::onFindInCommentsTriggered,
+                        Qt::CTRL + Qt::SHIFT + Qt::Key_M);
+    editMenu->addAction("Find in Chat &History...", this, &MainWindow::onFindInChatHistoryTriggered,
+                        Qt::CTRL + Qt::SHIFT + Qt::Key_H);
 
     // view menu
     QMenu *viewMenu = new QMenu("&View");
@@ -257,26 +303,30 @@ void MainWindow::setupMainMenu()
 
 void MainWindow::openDocument(const QString &fileName)
 {
-    QString readResult;
+    if (fileName.isEmpty())
+    {
+        return;
+    }
 
+    // file is read on worker thread, failure of reading is reported by documentLoadingFailed
     try
     {
-        readResult = FileManager().readFromFile(fileName);
+        mpDocumentManager->openDocument(fileName, true);
     }
-    catch (const IncorrectUserInput&)
+    catch (const FileOpeningFailure&)
     {
-        return;
+        QMessageBox::warning
+                (this,
+                 userMessages[UserMessages::ErrorTitle],
+                userMessages[UserMessages::FileOpeningErrorMsg]);
     }
-    catch (const FileOpeningFailure&)
+    catch (const DocumentPlacementFailure&)
     {
         QMessageBox::warning
                 (this,
                  userMessages[UserMessages::ErrorTitle],
                 userMessages[UserMessages::FileOpeningErrorMsg]);
-        return;
     }
-
-    mpDocumentManager->openDocument(fileName, true);
 }
 
 void MainWindow::createProjectViewer()
@@ -326,6 +376,38 @@ void MainWindow::createButtomPanel()
     mpBottomPanelDock = new BottomPanelDock(this);
     mpBottomPanelDock->setObjectName("mpBottomPanelDock");
     addDockWidget(Qt::BottomDockWidgetArea, mpBottomPanelDock);
+
+    // search in project sees unsaved changes of opened documents
+    ProjectSearchWidget *pProjectSearchWgt = mpBottomPanelDock->getProjectSearchWidget();
+    pProjectSearchWgt->setOpenedBuffersProvider([this]()
+    {
+        return mpDocumentManager->getUnsavedDocuments();
+    });
+    connect(pProjectSearchWgt, &ProjectSearchWidget::openFileAtLine, this, &MainWindow::onOpenFileAtLine);
+    connect(mpBottomPanelDock->getCommentsSearchWidget(), &HistorySearchWidget::openFileAtLine,
+            this, &MainWindow::onOpenFileAtLine);
+}
+
+void MainWindow::createLoadingIndicator()
+{
+    mpLoadingProgressBar = new QProgressBar;
+    mpLoadingProgressBar->setRange(0, 100);
+    mpLoadingProgressBar->setMaximumWidth(200);
+    mpLoadingProgressBar->hide();
+    mpCancelLoadingBtn = new QPushButton(tr("Cancel"));
+    mpCancelLoadingBtn->hide();
+    statusBar()->addPermanentWidget(mpLoadingProgressBar);
+    statusBar()->addPermanentWidget(mpCancelLoadingBtn);
+
+    connect(mpCancelLoadingBtn, &QPushButton::clicked, mpDocumentManager.data(), &DocumentManager::cancelLoading);
+    connect(mpDocumentManager.data(), &DocumentManager::documentLoadingProgress,
+            this, &MainWindow::onDocumentLoadingProgress);
+    connect(mpDocumentManager.data(), &DocumentManager::documentLoadingFinished,
+            this, &MainWindow::onDocumentLoadingStopped);
+    connect(mpDocumentManager.data(), &DocumentManager::documentLoadingCancelled,
+            this, &MainWindow::onDocumentLoadingStopped);
+    connect(mpDocumentManager.data(), &DocumentManager::documentLoadingFailed,
+            this, &MainWindow::onDocumentLoadingFailed);
 }
 
 void MainWindow::onNewFileTriggered()
@@ -344,6 +426,7 @@ void MainWindow::onNewFileTriggered()
     NewFileDialog newFileDialog
             (fileExtensions,
              mpDocumentManager->getCurrentProjectPath(),
+             mpDocumentManager->getProjectFileIndex(),
              this);
 
     QString newFileName;
@@ -434,6 +517,27 @@ void MainWindow::onOpenFileTriggered()
     openDocument(fileName);
 }
 
+void MainWindow::onQuickOpenTriggered()
+{
+    // check if project is opened
+    if (!mpDocumentManager->projectOpened())
+    {
+        QMessageBox::warning
+                (this,
+                 userMessages[UserMessages::ProjectNotOpenedTitle],
+                userMessages[UserMessages::ProjectNotOpenedMsg]);
+        return;
+    }
+
+    // palette is created once & follows index of currently opened project
+    if (!mpQuickOpenDialog)
+    {
+        mpQuickOpenDialog = new QuickOpenDialog(mpDocumentManager->getProjectFileIndex(), this);
+        connect(mpQuickOpenDialog, &QuickOpenDialog::fileSelected, this, &MainWindow::openDocument);
+    }
+    mpQuickOpenDialog->start();
+}
+
 void MainWindow::onOpenProjectTriggered()
 {
     // check if other project is opened
@@ -473,6 +577,8 @@ void MainWindow::onOpenProjectTriggered()
 
     mpProjectViewerDock->setDir(dirName);
     mpDocumentManager->openProject(dirName);
+    // tabs which were opened when project was closed last time
+    mpDocumentManager->restoreSession();
 }
 
 void MainWindow::onCloseProjectTriggered()
@@ -502,16 +608,12 @@ void MainWindow::onCloseProjectTriggered()
         {
         case QDialogButtonBox::StandardButton::YesToAll:
         {
-            try
-            {                
-                // saving changes to opened documents
-                mpDocumentManager->saveAllDocuments();
-            } catch (const FileOpeningFailure&)
+            // saving changes to opened documents, they have to be written before closing
+            mpDocumentManager->saveAllDocuments();
+            // if any of files could not be saved then user is warned
+            // (see onDocumentSavingFailed) & action is interrupted
+            if (!mpDocumentManager->waitForSaves())
             {
-                // if any of files could not be opened to save changes to
-                // document then user is warned & action is interrupted
-                QMessageBox::warning(this, userMessages[UserMessages::ErrorTitle],
-                        userMessages[UserMessages::FileOpeningForSavingErrorMsg]);
                 return;
             }
             break;
@@ -530,7 +632,8 @@ void MainWindow::onCloseProjectTriggered()
         }
         }
     }
-    // all documents are closed
+    // opened tabs are remembered & all documents are closed
+    mpDocumentManager->saveSession();
     mpDocumentManager->closeAllDocumentsWithoutSaving();
     // project is closed
     mpDocumentManager->closeCurrentProject();
@@ -553,22 +656,9 @@ void MainWindow::onOpenStartPage()
 
 void MainWindow::onSaveFileTriggered()
 {
-    try
-    {
-        // if document was modified, it is saved &
-        // message is shown on the status bar
-        if (mpDocumentManager->saveDocument())
-        {
-            statusBar()->showMessage(userMessages[UserMessages::DocumentSavedMsg], 3000);
-        }
-    }
-    catch (const FileOpeningFailure&)
-    {
-        QMessageBox::information
-                (this,
-                 userMessages[UserMessages::ErrorTitle],
-                userMessages[UserMessages::FileOpeningForSavingErrorMsg]);
-    }
+    // if document was modified, it is saved in background &
+    // message is shown on the status bar when it's written
+    mpDocumentManager->saveDocument();
 }
 
 void MainWindow::onSaveFileAsTriggered()
@@ -617,20 +707,8 @@ void MainWindow::onSaveFileAsTriggered()
 
 void MainWindow::onSaveAllFilesTriggered()
 {
-    try
-    {
-        if (mpDocumentManager->saveAllDocuments())
-        {
-            statusBar()->showMessage(userMessages[UserMessages::DocumentSavedMsg], 3000);
-        }
-    }
-    catch (const FileOpeningFailure&)
-    {
-        QMessageBox::information
-                (this,
-                 userMessages[UserMessages::ErrorTitle],
-                userMessages[UserMessages::FileOpeningForSavingErrorMsg]);
-    }
+    // modified documents are written in parallel without blocking editing
+    mpDocumentManager->saveAllDocuments();
 }
 
 void MainWindow::onCloseFileTriggered()
@@ -681,7 +759,60 @@ void MainWindow::onSelectAllTriggered()
 
 void MainWindow::onFindTriggered()
 {
-    //
+    // dialog is created once & works with document which was last in focus
+    if (!mpFindReplaceDialog)
+    {
+        mpFindReplaceDialog = new FindReplaceDialog([this]()
+        {
+            return mpDocumentManager->getLastDocumentInFocus();
+        }, this);
+    }
+    mpFindReplaceDialog->start();
+}
+
+void MainWindow::onFindInProjectTriggered()
+{
+    // check if project is opened
+    if (!mpDocumentManager->projectOpened())
+    {
+        QMessageBox::warning
+                (this,
+                 userMessages[UserMessages::ProjectNotOpenedTitle],
+                userMessages[UserMessages::ProjectNotOpenedMsg]);
+        return;
+    }
+
+    mpBottomPanelDock->getProjectSearchWidget()->setSearchScope(mpDocumentManager->getCurrentProjectPath(),
+                                                                getFileExtensions());
+    mpBottomPanelDock->showProjectSearchTab();
+}
+
+void MainWindow::onFindInCommentsTriggered()
+{
+    // comments are stored in database of opened project
+    if (!mpDocumentManager->projectOpened())
+    {
+        QMessageBox::warning
+                (this,
+                 userMessages[UserMessages::ProjectNotOpenedTitle],
+                userMessages[UserMessages::ProjectNotOpenedMsg]);
+        return;
+    }
+    mpBottomPanelDock->showCommentsSearchTab();
+}
+
+void MainWindow::onFindInChatHistoryTriggered()
+{
+    // chat history is stored in database of opened project
+    if (!mpDocumentManager->projectOpened())
+    {
+        QMessageBox::warning
+                (this,
+                 userMessages[UserMessages::ProjectNotOpenedTitle],
+                userMessages[UserMessages::ProjectNotOpenedMsg]);
+        return;
+    }
+    mpChatWindowDock->showHistorySearch();
 }
 
 void MainWindow::onFullScreenTriggered()
@@ -714,6 +845,96 @@ void MainWindow::onShowBottomPanel()
     mpBottomPanelDock->show();
 }
 
+void MainWindow::onDocumentLoadingProgress(const QString &fileName, int percent)
+{
+    // small files are loaded before indicator would be noticed
+    if (percent == 100 && !mLoadingDocuments.contains(fileName))
+    {
+        return;
+    }
+    mLoadingDocuments.insert(fileName);
+    mpLoadingProgressBar->setValue(percent);
+    mpLoadingProgressBar->show();
+    mpCancelLoadingBtn->show();
+    statusBar()->showMessage(userMessages[UserMessages::DocumentLoadingMsg] + fileName);
+}
+
+void MainWindow::onDocumentLoadingStopped(const QString &fileName)
+{
+    if (!mLoadingDocuments.remove(fileName) || !mLoadingDocuments.isEmpty())
+    {
+        return;
+    }
+    mpLoadingProgressBar->hide();
+    mpCancelLoadingBtn->hide();
+    statusBar()->clearMessage();
+}
+
+void MainWindow::onDocumentLoadingFailed(const QString &fileName)
+{
+    onDocumentLoadingStopped(fileName);
+    QMessageBox::warning
+            (this,
+             userMessages[UserMessages::ErrorTitle],
+            userMessages[UserMessages::FileOpeningErrorMsg]);
+}
+
+void MainWindow::onDocumentSaved(const QString &fileName)
+{
+    statusBar()->showMessage(userMessages[UserMessages::DocumentSavedMsg] + ": " + fileName, 3000);
+}
+
+void MainWindow::onDocumentSavingFailed(const QString &fileName)
+{
+    QMessageBox::warning
+            (this,
+             userMessages[UserMessages::ErrorTitle],
+            userMessages[UserMessages::FileOpeningForSavingErrorMsg] + ":\n" + fileName);
+}
+
+void MainWindow::onDocumentsChangedExternally(const QStringList &fileNames)
+{
+    for (const auto &fileName : fileNames)
+    {
+        if (!mExternallyChangedDocuments.contains(fileName))
+        {
+            mExternallyChangedDocuments << fileName;
+        }
+    }
+    // prompt isn't nested, files of later batches are asked about by the shown one
+    if (mExternalChangesPromptShown)
+    {
+        return;
+    }
+
+    mExternalChangesPromptShown = true;
+    while (!mExternallyChangedDocuments.isEmpty())
+    {
+        const QStringList changedDocuments = mExternallyChangedDocuments;
+        mExternallyChangedDocuments.clear();
+
+        auto reply = QMessageBox::question
+                (this,
+                 userMessages[UserMessages::FileChangedExternallyTitle],
+                userMessages[UserMessages::FileChangedExternallyMsg] + changedDocuments.join("\n"));
+
+        if (reply == QMessageBox::Yes)
+        {
+            for (const auto &fileName : changedDocuments)
+            {
+                mpDocumentManager->reloadDocument(fileName);
+            }
+        }
+    }
+    mExternalChangesPromptShown = false;
+}
+
+void MainWindow::onOpenFileAtLine(const QString &fileName, int line)
+{
+    openDocument(fileName);
+    mpDocumentManager->moveCursorToLine(fileName, line);
+}
+
 void MainWindow::onCombineAreas()
 {
     mpDocumentManager->combineDocAreas();
@@ -859,16 +1080,15 @@ void MainWindow::closeEvent(QCloseEvent *event)
     {
     case QDialogButtonBox::StandardButton::YesToAll:
     {
-        try
+        mpDocumentManager->saveAllDocuments();
+        // if any of files could not be saved then user is warned
+        // (see onDocumentSavingFailed) & closeEvent is ignored
+        if (mpDocumentManager->waitForSaves())
         {
-            mpDocumentManager->saveAllDocuments();
             event->accept();
-        } catch (const FileOpeningFailure&)
+        }
+        else
         {
-            // if any of files could not be opened to save changes to
-            // document then user is warned & closeEvent is ignored
-            QMessageBox::warning(this, userMessages[UserMessages::ErrorTitle],
-                    userMessages[UserMessages::FileOpeningForSavingErrorMsg]);
             event->ignore();
         }
         return;
@@ -894,6 +1114,7 @@ void MainWindow::closeEvent(QCloseEvent *event)
 MainWindow::~MainWindow()
 {
     saveMainWindowState();
+    mpDocumentManager->saveSession();
     StoreConf conf;
     conf.saveConFile();
 
@@ -1019,9 +1240,12 @@ void MainWindow::databaseConnect(QString directory)
     database.addTableUser();
     database.addTableComment();
     database.addTableMessage();
+    database.migrateSchema();
 }
 
 void MainWindow::databaseDisconnect()
 {
-    delete db;
+    // connections are owned by pool
+    ConnectionGetter::closeThreadConnections();
+    db = nullptr;
 }
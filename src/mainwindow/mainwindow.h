@@ -2,6 +2,7 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
+#include <QSet>
 
 namespace Ui
 {
@@ -19,7 +20,11 @@ class BottomPanelDock;
 class DocumentManager;
 class QListWidgetItem;
 class ChatWindowDock;
+class FindReplaceDialog;
+class QuickOpenDialog;
 class QMdiSubWindow;
+class QProgressBar;
+class QPushButton;
 class CodeEditor;
 class Browser;
 class Connection;
@@ -34,6 +39,8 @@ public:
     explicit MainWindow(QWidget *parent = nullptr);
     QStringList getFileExtensions()const;
     void showStartPage();
+    // unsaved changes left by crashed session are opened if user wants
+    void recoverUnsavedDocuments();
     ~MainWindow();
 
 private:
@@ -47,12 +54,23 @@ private:
     QScopedPointer<PaletteConfigurator> mpPaletteConfigurator;
     Connection *db;
     FileDb* dbFileManager;
+    FindReplaceDialog *mpFindReplaceDialog;
+    QuickOpenDialog *mpQuickOpenDialog;
+    // progress of documents loading is shown in status bar
+    QProgressBar *mpLoadingProgressBar;
+    QPushButton *mpCancelLoadingBtn;
+    QSet<QString> mLoadingDocuments;
+    // files changed on disk are asked about in one prompt, changes which come
+    // while it's shown are asked about after it
+    QStringList mExternallyChangedDocuments;
+    bool mExternalChangesPromptShown;
 
     void setupMainMenu();    
     void openDocument(const QString &fileName);
     void createProjectViewer();
     void createChatWindow();
     void createButtomPanel();
+    void createLoadingIndicator();
 
     void saveMainWindowState();
     void restoreMainWindowState();
@@ -72,6 +90,7 @@ private slots:
     void onNewFileTriggered();
     void onNewClassTriggered();
     void onOpenFileTriggered();
+    void onQuickOpenTriggered();
     void onOpenProjectTriggered();
     void onCloseProjectTriggered();
     void onOpenStartPage();
@@ -89,6 +108,9 @@ private slots:
     void onPasteTriggered();
     void onSelectAllTriggered();
     void onFindTriggered();
+    void onFindInProjectTriggered();
+    void onFindInCommentsTriggered();
+    void onFindInChatHistoryTriggered();
 
     // view menu
     void onFullScreenTriggered();
@@ -97,6 +119,17 @@ private slots:
     void onShowProjectViewerTriggered();
     void onShowChatWindowDockTriggered();
     void onShowBottomPanel();
+    void onOpenFileAtLine(const QString &fileName, int line);
+
+    // documents loading
+    void onDocumentLoadingProgress(const QString &fileName, int percent);
+    void onDocumentLoadingStopped(const QString &fileName);
+    void onDocumentLoadingFailed(const QString &fileName);
+
+    // documents saving
+    void onDocumentSaved(const QString &fileName);
+    void onDocumentSavingFailed(const QString &fileName);
+    void onDocumentsChangedExternally(const QStringList &fileNames);
     void onCombineAreas();
     void onCloseEmptyDocArea();   
 
@@ -1,7 +1,6 @@
 #include "newfilewizard.h"
 
 #include <QApplication>
-#include <QDirIterator>
 #include <QVBoxLayout>
 #include <QStringList>
 #include <QListWidget>
@@ -14,15 +13,18 @@
 #include <QDebug>
 #include <QDir>
 
+#include "projectfileindex.h"
 #include "usermessages.h"
 #include "filemanager.h"
 #include "utils.h"
 
 NewFileDialog::NewFileDialog(QStringList &fileExtensions,
                              QString projectPath,
+                             const ProjectFileIndex *pProjectFileIndex,
                              QWidget *pParent):
     QDialog (pParent),
-    mProjectPath(projectPath)
+    mProjectPath(projectPath),
+    mpProjectFileIndex(pProjectFileIndex)
 {
     setWindowTitle("New File");
 
@@ -121,23 +123,9 @@ bool NewFileDialog::isValidFilename(const QString &fileName)
     return !fileName.contains(QRegExp(invalidFileOrDirNameRegex));
 }
 
-bool NewFileDialog::directoryBelongsToProject(QString dirPath)
+bool NewFileDialog::directoryBelongsToProject(const QString &dirPath)
 {
-    if (mProjectPath == dirPath)
-    {
-        return true;
-    }
-    QDirIterator dirIter(mProjectPath, QDir::Dirs, QDirIterator::Subdirectories);
-
-    while (dirIter.hasNext())
-    {
-        dirIter.next();
-        if (dirIter.filePath() == dirPath)
-        {
-            return true;
-        }
-    }
-    return false;
+    return mpProjectFileIndex->containsDirectory(dirPath);
 }
 
 void NewFileDialog::onSelectDirectory()
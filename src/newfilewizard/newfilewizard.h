@@ -4,6 +4,7 @@
 #include <QDialog>
 #include <QMap>
 
+class ProjectFileIndex;
 class QListWidget;
 class QLineEdit;
 class QLabel;
@@ -15,6 +16,7 @@ class NewFileDialog: public QDialog
 public:
     explicit NewFileDialog(QStringList &fileExtensions,
                            QString projectPath,
+                           const ProjectFileIndex *pProjectFileIndex,
                            QWidget *pParent = nullptr);
     QString start();
 
@@ -22,11 +24,12 @@ private:
     QLineEdit *mpLine;
     QListWidget *mpExtensionsList;
     QString mProjectPath;
+    const ProjectFileIndex *mpProjectFileIndex;
     QString mFileName;
     QLineEdit *mpDirLbl;
 
     bool isValidFilename(const QString &fileName);
-    bool directoryBelongsToProject(QString dirPath);
+    bool directoryBelongsToProject(const QString &dirPath);
 
 private slots:
     void onSelectDirectory();
@@ -0,0 +1,142 @@
+#include "fuzzymatcher.h"
+
+namespace
+{
+const int SCORE_MATCH = 16;
+const int SCORE_CONSECUTIVE = 8;
+const int SCORE_BOUNDARY = 12;
+const int SCORE_CAMEL_CASE = 10;
+const int SCORE_IN_FILE_NAME = 6;
+const int SCORE_FILE_NAME_PREFIX = 24;
+const int PENALTY_GAP = 1;
+const int MAX_GAP_PENALTY = 8;
+
+int charBit(const unsigned char ch)
+{
+    if (ch >= 'a' && ch <= 'z')
+    {
+        return ch - 'a';
+    }
+    if (ch >= 'A' && ch <= 'Z')
+    {
+        return ch - 'A';
+    }
+    if (ch >= '0' && ch <= '9')
+    {
+        return 26 + ch - '0';
+    }
+    // rest of ascii shares remaining bits, all non-ascii bytes share the last one
+    return ch < 0x80 ? 36 + ch % 27 : 63;
+}
+
+bool isBoundary(const char ch)
+{
+    return ch == '/' || ch == '_' || ch == '-' || ch == '.' || ch == ' ';
+}
+
+bool isLower(const char ch)
+{
+    return ch >= 'a' && ch <= 'z';
+}
+
+bool isUpper(const char ch)
+{
+    return ch >= 'A' && ch <= 'Z';
+}
+
+// finds query as subsequence of path[from, pathLength) with the shortest window
+// ending at the first possible position, positions are written to pPositions
+bool matchPositions(const char *pQuery, const int queryLength, const char *pLowerPath,
+                    const int from, const int pathLength, int *pPositions)
+{
+    // forward scan finds where the first complete match ends
+    int queryIndex = 0;
+    int position = from;
+    for (; position < pathLength; ++position)
+    {
+        if (pLowerPath[position] == pQuery[queryIndex] && ++queryIndex == queryLength)
+        {
+            break;
+        }
+    }
+    if (queryIndex != queryLength)
+    {
+        return false;
+    }
+
+    // backward scan from that end tightens the match
+    for (queryIndex = queryLength - 1; queryIndex >= 0; --position)
+    {
+        if (pLowerPath[position] == pQuery[queryIndex])
+        {
+            pPositions[queryIndex--] = position;
+        }
+    }
+    return true;
+}
+}
+
+quint64 fuzzyCharMask(const char *pText, const int length)
+{
+    quint64 rMask = 0;
+    for (int i = 0; i < length; ++i)
+    {
+        rMask |= quint64(1) << charBit(static_cast<unsigned char>(pText[i]));
+    }
+    return rMask;
+}
+
+int fuzzyScore(const char *pQuery, const int queryLength,
+               const char *pPath, const char *pLowerPath,
+               const int pathLength, const int nameOffset)
+{
+    int positions[FUZZY_MAX_QUERY_LENGTH];
+    const int queryLen = qMin(queryLength, FUZZY_MAX_QUERY_LENGTH);
+
+    // matches inside of file name are preferred to ones spread over directories
+    if (!matchPositions(pQuery, queryLen, pLowerPath, nameOffset, pathLength, positions)
+            && !matchPositions(pQuery, queryLen, pLowerPath, 0, pathLength, positions))
+    {
+        return FUZZY_NO_MATCH;
+    }
+
+    int rScore = 0;
+    int prevPosition = -1;
+    for (int i = 0; i < queryLen; ++i)
+    {
+        const int position = positions[i];
+        rScore += SCORE_MATCH;
+
+        if (prevPosition >= 0 && position == prevPosition + 1)
+        {
+            rScore += SCORE_CONSECUTIVE;
+        }
+        else if (prevPosition >= 0)
+        {
+            rScore -= qMin((position - prevPosition - 1) * PENALTY_GAP, MAX_GAP_PENALTY);
+        }
+
+        if (position == 0 || isBoundary(pPath[position - 1]))
+        {
+            rScore += SCORE_BOUNDARY;
+        }
+        else if (isUpper(pPath[position]) && isLower(pPath[position - 1]))
+        {
+            rScore += SCORE_CAMEL_CASE;
+        }
+
+        if (position >= nameOffset)
+        {
+            rScore += SCORE_IN_FILE_NAME;
+        }
+        prevPosition = position;
+    }
+
+    if (positions[0] == nameOffset)
+    {
+        rScore += SCORE_FILE_NAME_PREFIX;
+    }
+
+    // among equal matches shorter paths go first
+    return qMax(rScore * 4 - pathLength / 8, 0);
+}
@@ -0,0 +1,21 @@
+#ifndef FUZZYMATCHER_H
+#define FUZZYMATCHER_H
+
+#include <QtGlobal>
+
+const int FUZZY_NO_MATCH = -1;
+// longer queries are truncated, matched positions are kept on stack
+const int FUZZY_MAX_QUERY_LENGTH = 64;
+
+// set of characters present in text, one bit per character class,
+// path can match query only if its mask contains all bits of query mask
+quint64 fuzzyCharMask(const char *pText, const int length);
+
+// scores lower case query as subsequence of path (utf-8 bytes),
+// lowerPath is path with lower cased ascii letters, nameOffset is start of file name in path
+// returns FUZZY_NO_MATCH if path doesn't contain query characters in the same order
+int fuzzyScore(const char *pQuery, const int queryLength,
+               const char *pPath, const char *pLowerPath,
+               const int pathLength, const int nameOffset);
+
+#endif // FUZZYMATCHER_H
@@ -0,0 +1,599 @@
+#include "projectfileindex.h"
+
+#include <QDirIterator>
+#include <QRunnable>
+#include <QFileInfo>
+#include <algorithm>
+#include <QSet>
+#include <QDir>
+
+#include "fuzzymatcher.h"
+
+namespace
+{
+QByteArray toAsciiLower(QByteArray text)
+{
+    for (auto &ch : text)
+    {
+        if (ch >= 'A' && ch <= 'Z')
+        {
+            ch = static_cast<char>(ch - 'A' + 'a');
+        }
+    }
+    return text;
+}
+
+QString parentDirectory(const QString &relativePath)
+{
+    return relativePath.left(qMax(relativePath.lastIndexOf('/'), 0));
+}
+
+QString childPath(const QString &relativeDir, const QString &name)
+{
+    return relativeDir.isEmpty() ? name : relativeDir + '/' + name;
+}
+
+// canonical path is made of canonical path of parent directory,
+// so links are resolved by file system only for entries which are links
+QString canonicalChildPath(const QString &canonicalDir, const QFileInfo &fileInfo)
+{
+    if (fileInfo.isSymLink() || canonicalDir.isEmpty())
+    {
+        return fileInfo.canonicalFilePath();
+    }
+    return canonicalDir + '/' + fileInfo.fileName();
+}
+}
+
+// scans whole project tree on the thread of index pool
+class ProjectIndexBuildTask: public QRunnable
+{
+public:
+    ProjectIndexBuildTask(ProjectFileIndex *pIndex, const std::shared_ptr<std::atomic<bool>> &pCancelled,
+                          const int generation, const QString &rootPath):
+        mpIndex(pIndex), mpCancelled(pCancelled),
+        mGeneration(generation), mRootPath(rootPath)
+    {
+    }
+
+    void run() override
+    {
+        QStringList files;
+        QStringList directories;
+        QStringList canonicalFiles;
+        QStringList canonicalDirectories;
+        directories << QString();
+        canonicalDirectories << QFileInfo(mRootPath).canonicalFilePath();
+        QHash<QString, QString> canonicalDirectoryByPath;
+        canonicalDirectoryByPath.insert(QString(), canonicalDirectories.first());
+
+        // files of linked directories are indexed too, loops of links are skipped by iterator
+        QDirIterator dirIter(mRootPath, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot,
+                             QDirIterator::Subdirectories | QDirIterator::FollowSymlinks);
+        while (dirIter.hasNext() && !*mpCancelled)
+        {
+            const QString relativePath = dirIter.next().mid(mRootPath.size() + 1);
+            const QString canonicalPath = canonicalChildPath(
+                        canonicalDirectoryByPath.value(parentDirectory(relativePath)), dirIter.fileInfo());
+            if (dirIter.fileInfo().isDir())
+            {
+                directories << relativePath;
+                canonicalDirectories << canonicalPath;
+                canonicalDirectoryByPath.insert(relativePath, canonicalPath);
+            }
+            else
+            {
+                files << relativePath;
+                canonicalFiles << canonicalPath;
+            }
+        }
+
+        if (!*mpCancelled)
+        {
+            emit mpIndex->snapshotBuilt(mGeneration, files, directories, canonicalFiles, canonicalDirectories);
+        }
+    }
+
+private:
+    ProjectFileIndex *mpIndex;
+    std::shared_ptr<std::atomic<bool>> mpCancelled;
+    int mGeneration;
+    QString mRootPath;
+};
+
+ProjectFileIndex::ProjectFileIndex(QObject *pParent):
+    QObject (pParent),
+    mRemovedEntriesCount(0),
+    mReady(false),
+    mGeneration(0)
+{
+    mThreadPool.setMaxThreadCount(1);
+    connect(this, &ProjectFileIndex::snapshotBuilt, this, &ProjectFileIndex::onSnapshotBuilt,
+            Qt::QueuedConnection);
+    connect(&mWatcher, &QFileSystemWatcher::directoryChanged, this, &ProjectFileIndex::onDirectoryChanged);
+}
+
+ProjectFileIndex::~ProjectFileIndex()
+{
+    if (mpBuildCancelled)
+    {
+        *mpBuildCancelled = true;
+    }
+    mThreadPool.waitForDone();
+}
+
+void ProjectFileIndex::setRootPath(const QString &rootPath)
+{
+    clear();
+    mRootPath = QDir::cleanPath(rootPath);
+    mCanonicalRootPath = QFileInfo(mRootPath).canonicalFilePath();
+    mpBuildCancelled = std::make_shared<std::atomic<bool>>(false);
+    mThreadPool.start(new ProjectIndexBuildTask(this, mpBuildCancelled, mGeneration, mRootPath));
+}
+
+const QString& ProjectFileIndex::getRootPath() const
+{
+    return mRootPath;
+}
+
+void ProjectFileIndex::clear()
+{
+    // result of running scan is dropped by generation check
+    if (mpBuildCancelled)
+    {
+        *mpBuildCancelled = true;
+    }
+    ++mGeneration;
+
+    if (!mWatcher.directories().isEmpty())
+    {
+        mWatcher.removePaths(mWatcher.directories());
+    }
+    rebuild(QStringList(), QStringList());
+    mCanonicalPathByRelativePath.clear();
+    mRelativePathByCanonicalPath.clear();
+    mRootPath.clear();
+    mCanonicalRootPath.clear();
+    mReady = false;
+}
+
+bool ProjectFileIndex::isReady() const
+{
+    return mReady;
+}
+
+int ProjectFileIndex::size() const
+{
+    return mEntries.size() - mRemovedEntriesCount;
+}
+
+QVector<FuzzyMatch> ProjectFileIndex::findFuzzy(const QString &query, const int maxResults)
+{
+    QByteArray lowerQuery = toAsciiLower(query.toUtf8());
+    lowerQuery.replace(' ', "");
+    lowerQuery.truncate(FUZZY_MAX_QUERY_LENGTH);
+
+    QVector<FuzzyMatch> rMatches;
+    if (lowerQuery.isEmpty() || maxResults <= 0)
+    {
+        mLastQuery.clear();
+        return rMatches;
+    }
+
+    // paths which didn't match shorter query can't match the longer one
+    const bool narrowing = !mLastQuery.isEmpty() && lowerQuery.startsWith(mLastQuery);
+    const int candidatesCount = narrowing ? mLastCandidates.size() : mEntries.size();
+    QVector<int> candidates;
+    candidates.reserve(candidatesCount);
+
+    const quint64 queryMask = fuzzyCharMask(lowerQuery.constData(), lowerQuery.size());
+    const char *pPaths = mPackedPaths.constData();
+    const char *pLowerPaths = mPackedLowerPaths.constData();
+
+    // min-heap keeps the best results found so far
+    auto worseScore = [](const FuzzyMatch &left, const FuzzyMatch &right)
+    {
+        return left.mScore > right.mScore;
+    };
+    rMatches.reserve(maxResults + 1);
+
+    for (int i = 0; i < candidatesCount; ++i)
+    {
+        const int entry = narrowing ? mLastCandidates[i] : i;
+        const PathEntry &pathEntry = mEntries[entry];
+        if (!pathEntry.mLength || (pathEntry.mCharMask & queryMask) != queryMask)
+        {
+            continue;
+        }
+
+        const int score = fuzzyScore(lowerQuery.constData(), lowerQuery.size(),
+                                     pPaths + pathEntry.mOffset, pLowerPaths + pathEntry.mOffset,
+                                     pathEntry.mLength, pathEntry.mNameOffset);
+        if (score == FUZZY_NO_MATCH)
+        {
+            continue;
+        }
+        candidates.push_back(entry);
+
+        if (rMatches.size() < maxResults)
+        {
+            rMatches.push_back(FuzzyMatch {entry, score});
+            std::push_heap(rMatches.begin(), rMatches.end(), worseScore);
+        }
+        else if (score > rMatches.front().mScore)
+        {
+            std::pop_heap(rMatches.begin(), rMatches.end(), worseScore);
+            rMatches.back() = FuzzyMatch {entry, score};
+            std::push_heap(rMatches.begin(), rMatches.end(), worseScore);
+        }
+    }
+
+    std::sort(rMatches.begin(), rMatches.end(), worseScore);
+    mLastQuery = lowerQuery;
+    mLastCandidates.swap(candidates);
+    return rMatches;
+}
+
+QString ProjectFileIndex::getRelativePath(const int entry) const
+{
+    const PathEntry &pathEntry = mEntries[entry];
+    return QString::fromUtf8(mPackedPaths.constData() + pathEntry.mOffset, pathEntry.mLength);
+}
+
+QString ProjectFileIndex::getAbsolutePath(const int entry) const
+{
+    return toAbsolutePath(getRelativePath(entry));
+}
+
+bool ProjectFileIndex::containsFile(const QString &path) const
+{
+    QString relativePath;
+    if (!toIndexedPath(path, relativePath))
+    {
+        return false;
+    }
+    // until scan is finished file system is asked directly
+    return mReady ? mEntryByPath.contains(relativePath) : QFileInfo(path).isFile();
+}
+
+bool ProjectFileIndex::containsDirectory(const QString &path) const
+{
+    QString relativePath;
+    if (!toIndexedPath(path, relativePath))
+    {
+        return false;
+    }
+    return mReady ? mEntriesByDirectory.contains(relativePath) : QFileInfo(path).isDir();
+}
+
+void ProjectFileIndex::rebuild(const QStringList &files, const QStringList &directories)
+{
+    mPackedPaths.clear();
+    mPackedLowerPaths.clear();
+    mEntries.clear();
+    mEntryByPath.clear();
+    mEntriesByDirectory.clear();
+    mRemovedEntriesCount = 0;
+    mLastQuery.clear();
+    mLastCandidates.clear();
+
+    mEntries.reserve(files.size());
+    mEntryByPath.reserve(files.size());
+    for (const auto &directory : directories)
+    {
+        mEntriesByDirectory.insert(directory, QVector<int>());
+    }
+    for (const auto &file : files)
+    {
+        appendEntry(file);
+    }
+}
+
+int ProjectFileIndex::appendEntry(const QString &relativePath)
+{
+    const QByteArray path = relativePath.toUtf8();
+    const QByteArray lowerPath = toAsciiLower(path);
+
+    PathEntry pathEntry;
+    pathEntry.mOffset = mPackedPaths.size();
+    pathEntry.mLength = path.size();
+    pathEntry.mNameOffset = path.lastIndexOf('/') + 1;
+    pathEntry.mCharMask = fuzzyCharMask(lowerPath.constData(), lowerPath.size());
+    mPackedPaths += path;
+    mPackedLowerPaths += lowerPath;
+
+    const int rEntry = mEntries.size();
+    mEntries.push_back(pathEntry);
+    mEntryByPath.insert(relativePath, rEntry);
+    mEntriesByDirectory[parentDirectory(relativePath)].push_back(rEntry);
+    return rEntry;
+}
+
+void ProjectFileIndex::removeEntry(const int entry)
+{
+    // entry stays in packed buffer until compaction
+    const QString relativePath = getRelativePath(entry);
+    mEntryByPath.remove(relativePath);
+    removeCanonicalPath(relativePath);
+    mEntries[entry].mLength = 0;
+    ++mRemovedEntriesCount;
+}
+
+void ProjectFileIndex::scanDirectory(const QString &relativeDir, QStringList &addedFiles)
+{
+    const QString absoluteDir = toAbsolutePath(relativeDir);
+    QStringList newDirectories;
+    newDirectories << absoluteDir;
+    if (!mEntriesByDirectory.contains(relativeDir))
+    {
+        mEntriesByDirectory.insert(relativeDir, QVector<int>());
+    }
+    if (!mCanonicalPathByRelativePath.contains(relativeDir))
+    {
+        addCanonicalPath(relativeDir, QFileInfo(absoluteDir).canonicalFilePath());
+    }
+
+    QDirIterator dirIter(absoluteDir, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot,
+                         QDirIterator::Subdirectories | QDirIterator::FollowSymlinks);
+    while (dirIter.hasNext())
+    {
+        const QString path = dirIter.next();
+        const QString relativePath = toRelativePath(path);
+        const QString canonicalPath = canonicalChildPath(
+                    mCanonicalPathByRelativePath.value(parentDirectory(relativePath)), dirIter.fileInfo());
+        if (dirIter.fileInfo().isDir())
+        {
+            if (!mEntriesByDirectory.contains(relativePath))
+            {
+                mEntriesByDirectory.insert(relativePath, QVector<int>());
+            }
+            addCanonicalPath(relativePath, canonicalPath);
+            newDirectories << path;
+        }
+        else if (!mEntryByPath.contains(relativePath))
+        {
+            appendEntry(relativePath);
+            addCanonicalPath(relativePath, canonicalPath);
+            addedFiles << path;
+        }
+    }
+    mWatcher.addPaths(newDirectories);
+}
+
+void ProjectFileIndex::removeDirectory(const QString &relativeDir)
+{
+    const QString prefix = relativeDir + '/';
+    QStringList removedDirectories;
+
+    for (auto dirIter = mEntriesByDirectory.begin(); dirIter != mEntriesByDirectory.end();)
+    {
+        if (relativeDir.isEmpty() || dirIter.key() == relativeDir || dirIter.key().startsWith(prefix))
+        {
+            for (const auto entry : dirIter.value())
+            {
+                if (mEntries[entry].mLength)
+                {
+                    removeEntry(entry);
+                }
+            }
+            removedDirectories << toAbsolutePath(dirIter.key());
+            removeCanonicalPath(dirIter.key());
+            dirIter = mEntriesByDirectory.erase(dirIter);
+        }
+        else
+        {
+            ++dirIter;
+        }
+    }
+    if (!removedDirectories.isEmpty())
+    {
+        mWatcher.removePaths(removedDirectories);
+    }
+}
+
+void ProjectFileIndex::addCanonicalPath(const QString &relativePath, const QString &canonicalPath)
+{
+    if (canonicalPath.isEmpty())
+    {
+        return;
+    }
+    mCanonicalPathByRelativePath.insert(relativePath, canonicalPath);
+    // the first of entries which lead to the same file is found by its canonical path
+    if (!mRelativePathByCanonicalPath.contains(canonicalPath))
+    {
+        mRelativePathByCanonicalPath.insert(canonicalPath, relativePath);
+    }
+}
+
+void ProjectFileIndex::removeCanonicalPath(const QString &relativePath)
+{
+    const QString canonicalPath = mCanonicalPathByRelativePath.take(relativePath);
+    auto pathIter = mRelativePathByCanonicalPath.find(canonicalPath);
+    if (pathIter != mRelativePathByCanonicalPath.end() && pathIter.value() == relativePath)
+    {
+        mRelativePathByCanonicalPath.erase(pathIter);
+    }
+}
+
+void ProjectFileIndex::compactIfNeeded()
+{
+    if (mRemovedEntriesCount * 2 <= mEntries.size())
+    {
+        return;
+    }
+
+    QStringList files;
+    files.reserve(size());
+    for (int entry = 0; entry < mEntries.size(); ++entry)
+    {
+        if (mEntries[entry].mLength)
+        {
+            files << getRelativePath(entry);
+        }
+    }
+    rebuild(files, mEntriesByDirectory.keys());
+}
+
+QString ProjectFileIndex::toRelativePath(const QString &absolutePath) const
+{
+    return absolutePath.size() > mRootPath.size() ? absolutePath.mid(mRootPath.size() + 1) : QString();
+}
+
+QString ProjectFileIndex::toAbsolutePath(const QString &relativePath) const
+{
+    return relativePath.isEmpty() ? mRootPath : mRootPath + '/' + relativePath;
+}
+
+bool ProjectFileIndex::toIndexedPath(const QString &path, QString &relativePath) const
+{
+    if (mRootPath.isEmpty())
+    {
+        return false;
+    }
+    // path is only cleaned, links were resolved when paths of project were indexed
+    const QString cleanPath = QDir::cleanPath(QFileInfo(path).absoluteFilePath());
+    for (const auto &rootPath : {mRootPath, mCanonicalRootPath})
+    {
+        if (rootPath.isEmpty())
+        {
+            continue;
+        }
+        if (cleanPath == rootPath)
+        {
+            relativePath.clear();
+            return true;
+        }
+        if (cleanPath.startsWith(rootPath + '/'))
+        {
+            relativePath = cleanPath.mid(rootPath.size() + 1);
+            return true;
+        }
+    }
+
+    // path leads to file of project through link which points outside of it
+    auto pathIter = mRelativePathByCanonicalPath.constFind(cleanPath);
+    if (pathIter == mRelativePathByCanonicalPath.cend())
+    {
+        return false;
+    }
+    relativePath = pathIter.value();
+    return true;
+}
+
+void ProjectFileIndex::onSnapshotBuilt(int generation, QStringList files, QStringList directories,
+                                       QStringList canonicalFiles, QStringList canonicalDirectories)
+{
+    // snapshot of closed or reopened project
+    if (generation != mGeneration)
+    {
+        return;
+    }
+
+    rebuild(files, directories);
+    mCanonicalPathByRelativePath.clear();
+    mRelativePathByCanonicalPath.clear();
+    for (int i = 0; i < files.size(); ++i)
+    {
+        addCanonicalPath(files[i], canonicalFiles[i]);
+    }
+    for (int i = 0; i < directories.size(); ++i)
+    {
+        addCanonicalPath(directories[i], canonicalDirectories[i]);
+    }
+
+    QStringList watchedDirectories;
+    watchedDirectories.reserve(directories.size());
+    for (const auto &directory : directories)
+    {
+        watchedDirectories << toAbsolutePath(directory);
+    }
+    mWatcher.addPaths(watchedDirectories);
+
+    mReady = true;
+    emit indexReady();
+}
+
+void ProjectFileIndex::onDirectoryChanged(const QString &path)
+{
+    const QString relativeDir = toRelativePath(path);
+    if (!mReady || !mEntriesByDirectory.contains(relativeDir))
+    {
+        return;
+    }
+
+    QStringList addedFiles;
+    QDir dir(path);
+    if (!dir.exists())
+    {
+        removeDirectory(relativeDir);
+    }
+    else
+    {
+        // files of directory are compared with indexed ones
+        QHash<QString, QFileInfo> currentFiles;
+        for (const auto &fileInfo : dir.entryInfoList(QDir::Files))
+        {
+            currentFiles.insert(childPath(relativeDir, fileInfo.fileName()), fileInfo);
+        }
+
+        QVector<int> keptEntries;
+        for (const auto entry : mEntriesByDirectory.value(relativeDir))
+        {
+            if (!mEntries[entry].mLength)
+            {
+                continue;
+            }
+            if (currentFiles.remove(getRelativePath(entry)))
+            {
+                keptEntries << entry;
+            }
+            else
+            {
+                removeEntry(entry);
+            }
+        }
+        mEntriesByDirectory[relativeDir] = keptEntries;
+        const QString canonicalDir = mCanonicalPathByRelativePath.value(relativeDir);
+        for (auto fileIter = currentFiles.cbegin(); fileIter != currentFiles.cend(); ++fileIter)
+        {
+            appendEntry(fileIter.key());
+            addCanonicalPath(fileIter.key(), canonicalChildPath(canonicalDir, fileIter.value()));
+            addedFiles << toAbsolutePath(fileIter.key());
+        }
+
+        // new subdirectories are scanned, removed ones are dropped with their content
+        QSet<QString> currentDirectories;
+        for (const auto &dirName : dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot))
+        {
+            const QString relativeSubdir = childPath(relativeDir, dirName);
+            currentDirectories << relativeSubdir;
+            if (!mEntriesByDirectory.contains(relativeSubdir))
+            {
+                scanDirectory(relativeSubdir, addedFiles);
+            }
+        }
+
+        QStringList removedDirectories;
+        for (auto dirIter = mEntriesByDirectory.cbegin(); dirIter != mEntriesByDirectory.cend(); ++dirIter)
+        {
+            const QString &key = dirIter.key();
+            if (!key.isEmpty() && key != relativeDir && parentDirectory(key) == relativeDir
+                    && !currentDirectories.contains(key))
+            {
+                removedDirectories << key;
+            }
+        }
+        for (const auto &removedDirectory : removedDirectories)
+        {
+            removeDirectory(removedDirectory);
+        }
+    }
+
+    mLastQuery.clear();
+    compactIfNeeded();
+    emit indexChanged();
+    if (!addedFiles.isEmpty())
+    {
+        emit filesAdded(addedFiles);
+    }
+}
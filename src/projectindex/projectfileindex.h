@@ -0,0 +1,110 @@
+#ifndef PROJECTFILEINDEX_H
+#define PROJECTFILEINDEX_H
+
+#include <QFileSystemWatcher>
+#include <QStringList>
+#include <QThreadPool>
+#include <QByteArray>
+#include <QObject>
+#include <QVector>
+#include <QHash>
+#include <atomic>
+#include <memory>
+
+struct FuzzyMatch
+{
+    int mEntry;
+    int mScore;
+};
+
+// in-memory list of all project files, built in background on project opening
+// & kept up to date by watching project directories
+class ProjectFileIndex: public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ProjectFileIndex(QObject *pParent = nullptr);
+    ~ProjectFileIndex();
+
+    void setRootPath(const QString &rootPath);
+    const QString& getRootPath() const;
+    void clear();
+    bool isReady() const;
+    int size() const;
+
+    // best matches of query ordered by score
+    QVector<FuzzyMatch> findFuzzy(const QString &query, const int maxResults);
+    QString getRelativePath(const int entry) const;
+    QString getAbsolutePath(const int entry) const;
+
+    // membership checks are hash lookups of cleaned absolute paths (file system isn't asked),
+    // paths inside project tree & canonical paths of its files & directories are found
+    bool containsFile(const QString &path) const;
+    bool containsDirectory(const QString &path) const;
+
+signals:
+    void indexReady();
+    void indexChanged();
+    // absolute paths of files which appeared in watched directories (e.g. were renamed or moved)
+    void filesAdded(const QStringList &fileNames);
+    // result of background scan, is delivered to the gui thread through queued connection
+    // canonical paths are absolute paths of files & directories with resolved links
+    void snapshotBuilt(int generation, QStringList files, QStringList directories,
+                       QStringList canonicalFiles, QStringList canonicalDirectories);
+
+private:
+    // paths are packed one after another in the single buffer,
+    // so matching walks memory sequentially
+    struct PathEntry
+    {
+        int mOffset;
+        int mLength;// 0 for removed entries
+        int mNameOffset;
+        quint64 mCharMask;
+    };
+
+    QByteArray mPackedPaths;
+    // the same layout as mPackedPaths with lower cased ascii letters
+    QByteArray mPackedLowerPaths;
+    QVector<PathEntry> mEntries;
+    int mRemovedEntriesCount;
+
+    // relative file path -> entry, relative dir path -> entries of its files
+    QHash<QString, int> mEntryByPath;
+    QHash<QString, QVector<int>> mEntriesByDirectory;
+    // links are resolved once when files & directories are indexed
+    QHash<QString, QString> mCanonicalPathByRelativePath;
+    QHash<QString, QString> mRelativePathByCanonicalPath;
+
+    // candidates of the last query, next query which extends it is matched only against them
+    QByteArray mLastQuery;
+    QVector<int> mLastCandidates;
+
+    QString mRootPath;
+    QString mCanonicalRootPath;
+    bool mReady;
+    int mGeneration;
+    QFileSystemWatcher mWatcher;
+    QThreadPool mThreadPool;
+    std::shared_ptr<std::atomic<bool>> mpBuildCancelled;
+
+    void rebuild(const QStringList &files, const QStringList &directories);
+    int appendEntry(const QString &relativePath);
+    void removeEntry(const int entry);
+    void scanDirectory(const QString &relativeDir, QStringList &addedFiles);
+    void removeDirectory(const QString &relativeDir);
+    void addCanonicalPath(const QString &relativePath, const QString &canonicalPath);
+    void removeCanonicalPath(const QString &relativePath);
+    void compactIfNeeded();
+    QString toRelativePath(const QString &absolutePath) const;
+    QString toAbsolutePath(const QString &relativePath) const;
+    bool toIndexedPath(const QString &path, QString &relativePath) const;
+
+private slots:
+    void onSnapshotBuilt(int generation, QStringList files, QStringList directories,
+                         QStringList canonicalFiles, QStringList canonicalDirectories);
+    void onDirectoryChanged(const QString &path);
+};
+
+#endif // PROJECTFILEINDEX_H
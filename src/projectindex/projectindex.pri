@@ -0,0 +1,12 @@
+DEPENDPATH += $$PWD
+INCLUDEPATH += $$PWD
+
+HEADERS += \
+    $$PWD/fuzzymatcher.h \
+    $$PWD/projectfileindex.h \
+    $$PWD/quickopendialog.h
+
+SOURCES += \
+    $$PWD/fuzzymatcher.cpp \
+    $$PWD/projectfileindex.cpp \
+    $$PWD/quickopendialog.cpp
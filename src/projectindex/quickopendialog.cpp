@@ -0,0 +1,114 @@
+#include "quickopendialog.h"
+
+#include <QApplication>
+#include <QListWidget>
+#include <QBoxLayout>
+#include <QKeyEvent>
+#include <QLineEdit>
+#include <QLabel>
+
+#include "projectfileindex.h"
+
+QuickOpenDialog::QuickOpenDialog(ProjectFileIndex *pFileIndex, QWidget *pParent):
+    QDialog (pParent),
+    mpFileIndex(pFileIndex)
+{
+    setWindowTitle("Quick Open");
+    resize(600, 400);
+
+    mpSearchLine = new QLineEdit;
+    mpSearchLine->setPlaceholderText(tr("Type part of file name"));
+    mpSearchLine->installEventFilter(this);
+    mpResultsList = new QListWidget;
+    mpResultsList->setUniformItemSizes(true);
+    mpStatusLbl = new QLabel;
+
+    QVBoxLayout *pWdwLayout = new QVBoxLayout;
+    pWdwLayout->addWidget(mpSearchLine);
+    pWdwLayout->addWidget(mpResultsList);
+    pWdwLayout->addWidget(mpStatusLbl);
+    setLayout(pWdwLayout);
+
+    connect(mpSearchLine, &QLineEdit::textChanged, this, &QuickOpenDialog::updateResults);
+    connect(mpSearchLine, &QLineEdit::returnPressed, this, &QuickOpenDialog::onResultChosen);
+    connect(mpResultsList, &QListWidget::itemActivated, this, &QuickOpenDialog::onResultChosen);
+    connect(mpFileIndex, &ProjectFileIndex::indexReady, this, &QuickOpenDialog::updateResults);
+    connect(mpFileIndex, &ProjectFileIndex::indexChanged, this, [this]()
+    {
+        if (isVisible())
+        {
+            updateResults();
+        }
+    });
+}
+
+void QuickOpenDialog::start()
+{
+    mpSearchLine->selectAll();
+    updateResults();
+    show();
+    raise();
+    activateWindow();
+    mpSearchLine->setFocus();
+}
+
+void QuickOpenDialog::updateResults()
+{
+    mpResultsList->clear();
+    if (!mpFileIndex->isReady())
+    {
+        mpStatusLbl->setText(tr("Indexing project files..."));
+        return;
+    }
+
+    auto matches = mpFileIndex->findFuzzy(mpSearchLine->text(), QUICK_OPEN_MAX_RESULTS);
+    for (const auto &match : matches)
+    {
+        // file name goes first, its directory is shown after it
+        const QString relativePath = mpFileIndex->getRelativePath(match.mEntry);
+        const int nameStart = relativePath.lastIndexOf('/') + 1;
+        QString itemText = relativePath.mid(nameStart);
+        if (nameStart)
+        {
+            itemText += "    " + relativePath.left(nameStart - 1);
+        }
+
+        QListWidgetItem *pItem = new QListWidgetItem(itemText, mpResultsList);
+        pItem->setData(Qt::UserRole, mpFileIndex->getAbsolutePath(match.mEntry));
+    }
+
+    if (mpResultsList->count())
+    {
+        mpResultsList->setCurrentRow(0);
+    }
+    mpStatusLbl->setText(tr("%1 file(s) in project").arg(mpFileIndex->size()));
+}
+
+void QuickOpenDialog::onResultChosen()
+{
+    auto pItem = mpResultsList->currentItem();
+    if (!pItem)
+    {
+        return;
+    }
+    hide();
+    emit fileSelected(pItem->data(Qt::UserRole).toString());
+}
+
+bool QuickOpenDialog::eventFilter(QObject *pWatched, QEvent *pEvent)
+{
+    // list is navigated without leaving search line
+    if (pWatched == mpSearchLine && pEvent->type() == QEvent::KeyPress)
+    {
+        switch (static_cast<QKeyEvent*>(pEvent)->key())
+        {
+        case Qt::Key_Up:
+        case Qt::Key_Down:
+        case Qt::Key_PageUp:
+        case Qt::Key_PageDown:
+            QApplication::sendEvent(mpResultsList, pEvent);
+            return true;
+        }
+    }
+    return QDialog::eventFilter(pWatched, pEvent);
+}
@@ -0,0 +1,39 @@
+#ifndef QUICKOPENDIALOG_H
+#define QUICKOPENDIALOG_H
+
+#include <QDialog>
+
+class ProjectFileIndex;
+class QListWidget;
+class QLineEdit;
+class QLabel;
+
+const int QUICK_OPEN_MAX_RESULTS = 50;
+
+// palette for opening project files by fuzzy typed name
+class QuickOpenDialog: public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit QuickOpenDialog(ProjectFileIndex *pFileIndex, QWidget *pParent = nullptr);
+    void start();
+
+signals:
+    void fileSelected(const QString &fileName);
+
+private:
+    ProjectFileIndex *mpFileIndex;
+    QLineEdit *mpSearchLine;
+    QListWidget *mpResultsList;
+    QLabel *mpStatusLbl;
+
+private slots:
+    void updateResults();
+    void onResultChosen();
+
+protected:
+    bool eventFilter(QObject *pWatched, QEvent *pEvent) override;
+};
+
+#endif // QUICKOPENDIALOG_H
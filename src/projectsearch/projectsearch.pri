@@ -0,0 +1,12 @@
+DEPENDPATH += $$PWD
+INCLUDEPATH += $$PWD
+
+HEADERS += \
+    $$PWD/projectsearcher.h \
+    $$PWD/projectsearchresultsmodel.h \
+    $$PWD/projectsearchwidget.h
+
+SOURCES += \
+    $$PWD/projectsearcher.cpp \
+    $$PWD/projectsearchresultsmodel.cpp \
+    $$PWD/projectsearchwidget.cpp
@@ -0,0 +1,238 @@
+#include "projectsearcher.h"
+#include "documentregistry.h"
+
+#include <QDirIterator>
+#include <QRunnable>
+#include <QThread>
+#include <QTimer>
+#include <QFile>
+#include <cstring>
+
+namespace
+{
+// files with zero byte in the beginning are considered binary & skipped
+const qint64 BINARY_CHECK_SIZE = 8000;
+
+void searchInText(const QString &fileName, const QString &text,
+                  const SearchEngine &searchEngine, QVector<ProjectSearchHit> &hits)
+{
+    const QChar *pText = text.constData();
+    int lineNumber = 1;
+    int lineStart = 0;
+    int scannedPosition = 0;
+
+    SearchMatch match = searchEngine.findNext(text);
+    while (match.isValid())
+    {
+        // lines are counted only up to the match, text without hits is not rescanned
+        for (; scannedPosition < match.mPosition; ++scannedPosition)
+        {
+            if (pText[scannedPosition] == '\n')
+            {
+                ++lineNumber;
+                lineStart = scannedPosition + 1;
+            }
+        }
+
+        int lineEnd = text.indexOf('\n', match.mPosition);
+        if (lineEnd < 0)
+        {
+            lineEnd = text.size();
+        }
+        QString lineText = text.mid(lineStart, qMin(lineEnd - lineStart, SEARCH_MAX_LINE_PREVIEW));
+        if (lineText.endsWith('\r'))
+        {
+            lineText.chop(1);
+        }
+
+        hits.push_back(ProjectSearchHit {fileName, lineNumber, match.mPosition - lineStart,
+                                         match.mLength, lineText});
+        match = searchEngine.findNext(text, match.mPosition + qMax(match.mLength, 1));
+    }
+}
+
+void searchInFile(const QString &fileName, const SearchEngine &searchEngine,
+                  QVector<ProjectSearchHit> &hits)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly) || !file.size())
+    {
+        return;
+    }
+
+    // file is memory mapped, so its content is not copied before decoding
+    // mapping is released when file is destroyed
+    const qint64 size = file.size();
+    QByteArray readContent;
+    const char *pBytes = reinterpret_cast<const char*>(file.map(0, size));
+    if (!pBytes)
+    {
+        readContent = file.readAll();
+        pBytes = readContent.constData();
+    }
+
+    if (std::memchr(pBytes, 0, static_cast<size_t>(qMin(size, BINARY_CHECK_SIZE))))
+    {
+        return;
+    }
+    searchInText(fileName, QString::fromUtf8(pBytes, static_cast<int>(size)), searchEngine, hits);
+}
+}
+
+// walks project tree & schedules searching of found files in batches
+class ProjectWalkTask: public QRunnable
+{
+public:
+    ProjectWalkTask(ProjectSearcher *pSearcher, const std::shared_ptr<ProjectSearchSession> &pSession,
+                    const QString &projectPath, const QStringList &nameFilters):
+        mpSearcher(pSearcher), mpSession(pSession),
+        mProjectPath(projectPath), mNameFilters(nameFilters)
+    {
+    }
+
+    void run() override
+    {
+        QDirIterator dirIter(mProjectPath, mNameFilters, QDir::Files, QDirIterator::Subdirectories);
+        QStringList files;
+
+        while (dirIter.hasNext() && !mpSession->mCancelled)
+        {
+            files << dirIter.next();
+            if (files.size() == SEARCH_FILES_PER_TASK)
+            {
+                mpSearcher->scheduleFiles(mpSession, files);
+                files.clear();
+            }
+        }
+        if (!files.isEmpty())
+        {
+            mpSearcher->scheduleFiles(mpSession, files);
+        }
+        mpSearcher->finishTask(mpSession);
+    }
+
+private:
+    ProjectSearcher *mpSearcher;
+    std::shared_ptr<ProjectSearchSession> mpSession;
+    QString mProjectPath;
+    QStringList mNameFilters;
+};
+
+// searches pattern in the batch of files, idle pool threads pick up next batches
+class FileSearchTask: public QRunnable
+{
+public:
+    FileSearchTask(ProjectSearcher *pSearcher, const std::shared_ptr<ProjectSearchSession> &pSession,
+                   const QStringList &files):
+        mpSearcher(pSearcher), mpSession(pSession), mFiles(files)
+    {
+    }
+
+    void run() override
+    {
+        // every task uses its own copy of engine (copy of compiled regex is shallow)
+        const SearchEngine searchEngine = mpSession->mSearchEngine;
+
+        for (const auto &fileName : mFiles)
+        {
+            if (mpSession->mCancelled)
+            {
+                break;
+            }
+
+            QVector<ProjectSearchHit> hits;
+            // path is resolved only when there are unsaved documents
+            auto bufferIter = mpSession->mOpenedBuffers.isEmpty()
+                    ? mpSession->mOpenedBuffers.constEnd()
+                    : mpSession->mOpenedBuffers.constFind(DocumentRegistry::pathKey(fileName));
+            if (bufferIter != mpSession->mOpenedBuffers.constEnd())
+            {
+                searchInText(fileName, bufferIter.value(), searchEngine, hits);
+            }
+            else
+            {
+                searchInFile(fileName, searchEngine, hits);
+            }
+            ++mpSession->mFilesSearched;
+
+            // hits are streamed to the gui file by file
+            if (!hits.isEmpty() && !mpSession->mCancelled)
+            {
+                emit mpSearcher->hitsFound(mpSession->mId, hits);
+            }
+        }
+        mpSearcher->finishTask(mpSession);
+    }
+
+private:
+    ProjectSearcher *mpSearcher;
+    std::shared_ptr<ProjectSearchSession> mpSession;
+    QStringList mFiles;
+};
+
+ProjectSearcher::ProjectSearcher(QObject *pParent):
+    QObject (pParent),
+    mLastSearchId(0)
+{
+    qRegisterMetaType<QVector<ProjectSearchHit>>("QVector<ProjectSearchHit>");
+    // walking task occupies one thread, so at least one more is needed for searching
+    mThreadPool.setMaxThreadCount(qMax(2, QThread::idealThreadCount()));
+}
+
+ProjectSearcher::~ProjectSearcher()
+{
+    cancel();
+    mThreadPool.waitForDone();
+}
+
+int ProjectSearcher::start(const QString &projectPath, const QStringList &nameFilters,
+                           const QString &pattern, const SearchOptions &options,
+                           const QHash<QString, QString> &openedBuffers)
+{
+    // only one search is run at a time
+    cancel();
+
+    mpSession = std::make_shared<ProjectSearchSession>();
+    mpSession->mId = ++mLastSearchId;
+    mpSession->mSearchEngine.setPattern(pattern, options);
+    mpSession->mOpenedBuffers = openedBuffers;
+
+    // finishing is reported asynchronously, so caller gets id first
+    const int searchId = mpSession->mId;
+    if (!mpSession->mSearchEngine.isValid())
+    {
+        QTimer::singleShot(0, this, [this, searchId]()
+        {
+            emit searchFinished(searchId, 0);
+        });
+        return searchId;
+    }
+
+    mpSession->mPendingTasks = 1;
+    mThreadPool.start(new ProjectWalkTask(this, mpSession, projectPath, nameFilters));
+    return searchId;
+}
+
+void ProjectSearcher::cancel()
+{
+    if (mpSession)
+    {
+        mpSession->mCancelled = true;
+    }
+}
+
+void ProjectSearcher::scheduleFiles(const std::shared_ptr<ProjectSearchSession> &pSession,
+                                    const QStringList &files)
+{
+    ++pSession->mPendingTasks;
+    mThreadPool.start(new FileSearchTask(this, pSession, files));
+}
+
+void ProjectSearcher::finishTask(const std::shared_ptr<ProjectSearchSession> &pSession)
+{
+    // the last finished task reports the end of search
+    if (--pSession->mPendingTasks == 0)
+    {
+        emit searchFinished(pSession->mId, pSession->mFilesSearched);
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef PROJECTSEARCHER_H
+#define PROJECTSEARCHER_H
+
+#include <QThreadPool>
+#include <QStringList>
+#include <QMetaType>
+#include <QObject>
+#include <QVector>
+#include <QHash>
+#include <atomic>
+#include <memory>
+
+#include "searchengine.h"
+
+const int SEARCH_FILES_PER_TASK = 16;
+const int SEARCH_MAX_LINE_PREVIEW = 200;
+
+struct ProjectSearchHit
+{
+    QString mFileName;
+    int mLine;// starts from 1
+    int mColumn;// starts from 0
+    int mLength;
+    QString mLineText;
+};
+
+Q_DECLARE_METATYPE(ProjectSearchHit)
+Q_DECLARE_METATYPE(QVector<ProjectSearchHit>)
+
+// state shared by all tasks of one search
+struct ProjectSearchSession
+{
+    int mId;
+    SearchEngine mSearchEngine;
+    // unsaved content of opened documents takes precedence over files on disk,
+    // it's keyed by DocumentRegistry::pathKey, so relative paths & links lead to the same file
+    QHash<QString, QString> mOpenedBuffers;
+    std::atomic<bool> mCancelled {false};
+    std::atomic<int> mPendingTasks {0};
+    std::atomic<int> mFilesSearched {0};
+};
+
+// searches pattern in every project file on a thread pool,
+// hits are streamed back to the gui thread file by file
+class ProjectSearcher: public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ProjectSearcher(QObject *pParent = nullptr);
+    ~ProjectSearcher();
+
+    // returns id of started search, signals of previous searches can be told apart by it
+    int start(const QString &projectPath, const QStringList &nameFilters,
+              const QString &pattern, const SearchOptions &options,
+              const QHash<QString, QString> &openedBuffers);
+    void cancel();
+
+signals:
+    void hitsFound(int searchId, QVector<ProjectSearchHit> hits);
+    void searchFinished(int searchId, int filesSearched);
+
+private:
+    friend class ProjectWalkTask;
+    friend class FileSearchTask;
+
+    void scheduleFiles(const std::shared_ptr<ProjectSearchSession> &pSession, const QStringList &files);
+    void finishTask(const std::shared_ptr<ProjectSearchSession> &pSession);
+
+    QThreadPool mThreadPool;
+    std::shared_ptr<ProjectSearchSession> mpSession;
+    int mLastSearchId;
+};
+
+#endif // PROJECTSEARCHER_H
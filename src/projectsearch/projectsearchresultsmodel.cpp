@@ -0,0 +1,66 @@
+#include "projectsearchresultsmodel.h"
+
+ProjectSearchResultsModel::ProjectSearchResultsModel(QObject *pParent):
+    QAbstractListModel (pParent)
+{
+}
+
+int ProjectSearchResultsModel::rowCount(const QModelIndex &modelIndex) const
+{
+    return modelIndex.isValid() ? 0 : mHits.size();
+}
+
+QVariant ProjectSearchResultsModel::data(const QModelIndex &modelIndex, int role) const
+{
+    if (!modelIndex.isValid() || modelIndex.row() >= mHits.size())
+    {
+        return QVariant();
+    }
+
+    // row text is built only for rows view asks for
+    const ProjectSearchHit &hit = mHits[modelIndex.row()];
+    switch (role)
+    {
+    case Qt::DisplayRole:
+    {
+        QString fileName = hit.mFileName;
+        if (fileName.startsWith(mProjectPath))
+        {
+            fileName = fileName.mid(mProjectPath.size() + 1);
+        }
+        return fileName + ":" + QString::number(hit.mLine) + ":  " + hit.mLineText.trimmed();
+    }
+    case Qt::ToolTipRole:
+        return hit.mFileName;
+    case FileNameRole:
+        return hit.mFileName;
+    case LineRole:
+        return hit.mLine;
+    case ColumnRole:
+        return hit.mColumn;
+    }
+    return QVariant();
+}
+
+void ProjectSearchResultsModel::setProjectPath(const QString &projectPath)
+{
+    mProjectPath = projectPath;
+}
+
+void ProjectSearchResultsModel::appendHits(const QVector<ProjectSearchHit> &hits)
+{
+    if (hits.isEmpty())
+    {
+        return;
+    }
+    beginInsertRows(QModelIndex(), mHits.size(), mHits.size() + hits.size() - 1);
+    mHits += hits;
+    endInsertRows();
+}
+
+void ProjectSearchResultsModel::clear()
+{
+    beginResetModel();
+    mHits.clear();
+    endResetModel();
+}
@@ -0,0 +1,35 @@
+#ifndef PROJECTSEARCHRESULTSMODEL_H
+#define PROJECTSEARCHRESULTSMODEL_H
+
+#include <QAbstractListModel>
+
+#include "projectsearcher.h"
+
+// flat list of search hits, rows are appended while search is running
+class ProjectSearchResultsModel: public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum
+    {
+        FileNameRole = Qt::UserRole,
+        LineRole,
+        ColumnRole
+    };
+
+    explicit ProjectSearchResultsModel(QObject *pParent = nullptr);
+
+    int rowCount(const QModelIndex &modelIndex = QModelIndex()) const override;
+    QVariant data(const QModelIndex &modelIndex, int role = Qt::DisplayRole) const override;
+
+    void setProjectPath(const QString &projectPath);
+    void appendHits(const QVector<ProjectSearchHit> &hits);
+    void clear();
+
+private:
+    QVector<ProjectSearchHit> mHits;
+    QString mProjectPath;
+};
+
+#endif // PROJECTSEARCHRESULTSMODEL_H
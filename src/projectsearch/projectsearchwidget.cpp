@@ -0,0 +1,139 @@
+#include "projectsearchwidget.h"
+
+#include <QPushButton>
+#include <QBoxLayout>
+#include <QCheckBox>
+#include <QLineEdit>
+#include <QListView>
+#include <QLabel>
+
+#include "projectsearchresultsmodel.h"
+
+ProjectSearchWidget::ProjectSearchWidget(QWidget *pParent):
+    QWidget (pParent),
+    mCurrentSearchId(0)
+{
+    // search line & modes
+    mpSearchLine = new QLineEdit;
+    mpSearchLine->setPlaceholderText(tr("Find in project"));
+    mpCaseSensitiveBox = new QCheckBox(tr("Match case"));
+    mpWholeWordsBox = new QCheckBox(tr("Whole words"));
+    mpRegexBox = new QCheckBox(tr("Regular expression"));
+    mpSearchBtn = new QPushButton(tr("Search"));
+    mpStopBtn = new QPushButton(tr("Stop"));
+    mpStopBtn->setEnabled(false);
+    mpStatusLbl = new QLabel;
+
+    QHBoxLayout *pControlsLayout = new QHBoxLayout;
+    pControlsLayout->addWidget(mpSearchLine, 1);
+    pControlsLayout->addWidget(mpCaseSensitiveBox);
+    pControlsLayout->addWidget(mpWholeWordsBox);
+    pControlsLayout->addWidget(mpRegexBox);
+    pControlsLayout->addWidget(mpSearchBtn);
+    pControlsLayout->addWidget(mpStopBtn);
+    pControlsLayout->addWidget(mpStatusLbl);
+
+    // results list creates widgets only for visible rows
+    mpResultsModel = new ProjectSearchResultsModel(this);
+    mpResultsView = new QListView;
+    mpResultsView->setModel(mpResultsModel);
+    mpResultsView->setUniformItemSizes(true);
+    mpResultsView->setLayoutMode(QListView::Batched);
+    mpResultsView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    QVBoxLayout *pLayout = new QVBoxLayout;
+    pLayout->setContentsMargins(0, 0, 0, 0);
+    pLayout->addLayout(pControlsLayout);
+    pLayout->addWidget(mpResultsView);
+    setLayout(pLayout);
+
+    mpSearcher = new ProjectSearcher(this);
+    connect(mpSearcher, &ProjectSearcher::hitsFound, this, &ProjectSearchWidget::onHitsFound);
+    connect(mpSearcher, &ProjectSearcher::searchFinished, this, &ProjectSearchWidget::onSearchFinished);
+
+    connect(mpSearchLine, &QLineEdit::returnPressed, this, &ProjectSearchWidget::onSearch);
+    connect(mpSearchBtn, &QPushButton::clicked, this, &ProjectSearchWidget::onSearch);
+    connect(mpStopBtn, &QPushButton::clicked, this, &ProjectSearchWidget::onStop);
+    connect(mpResultsView, &QListView::activated, this, &ProjectSearchWidget::onResultActivated);
+}
+
+void ProjectSearchWidget::setSearchScope(const QString &projectPath, const QStringList &fileExtensions)
+{
+    mProjectPath = projectPath;
+    mpResultsModel->setProjectPath(projectPath);
+
+    // extensions from settings (".cpp") are turned into name filters ("*.cpp")
+    mNameFilters.clear();
+    for (const auto &extension : fileExtensions)
+    {
+        mNameFilters << "*" + extension;
+    }
+}
+
+void ProjectSearchWidget::setOpenedBuffersProvider(std::function<QHash<QString, QString>()> provider)
+{
+    mOpenedBuffersProvider = provider;
+}
+
+void ProjectSearchWidget::focusSearchLine()
+{
+    mpSearchLine->setFocus();
+    mpSearchLine->selectAll();
+}
+
+void ProjectSearchWidget::onSearch()
+{
+    if (mProjectPath.isEmpty() || mpSearchLine->text().isEmpty())
+    {
+        return;
+    }
+
+    SearchOptions options;
+    options.mCaseSensitive = mpCaseSensitiveBox->isChecked();
+    options.mWholeWords = mpWholeWordsBox->isChecked();
+    options.mRegularExpression = mpRegexBox->isChecked();
+
+    mpResultsModel->clear();
+    mpStatusLbl->setText(tr("Searching..."));
+    mpStopBtn->setEnabled(true);
+
+    mCurrentSearchId = mpSearcher->start(mProjectPath, mNameFilters, mpSearchLine->text(), options,
+                                         mOpenedBuffersProvider ? mOpenedBuffersProvider()
+                                                                : QHash<QString, QString>());
+}
+
+void ProjectSearchWidget::onStop()
+{
+    mpSearcher->cancel();
+    mpStopBtn->setEnabled(false);
+    mpStatusLbl->setText(tr("%1 match(es), search stopped").arg(mpResultsModel->rowCount()));
+}
+
+void ProjectSearchWidget::onHitsFound(int searchId, QVector<ProjectSearchHit> hits)
+{
+    // hits of cancelled searches can still be queued
+    if (searchId != mCurrentSearchId)
+    {
+        return;
+    }
+    mpResultsModel->appendHits(hits);
+    mpStatusLbl->setText(tr("%1 match(es)...").arg(mpResultsModel->rowCount()));
+}
+
+void ProjectSearchWidget::onSearchFinished(int searchId, int filesSearched)
+{
+    if (searchId != mCurrentSearchId)
+    {
+        return;
+    }
+    mpStopBtn->setEnabled(false);
+    mpStatusLbl->setText(tr("%1 match(es) in %2 file(s)")
+                         .arg(mpResultsModel->rowCount())
+                         .arg(filesSearched));
+}
+
+void ProjectSearchWidget::onResultActivated(const QModelIndex &index)
+{
+    emit openFileAtLine(index.data(ProjectSearchResultsModel::FileNameRole).toString(),
+                        index.data(ProjectSearchResultsModel::LineRole).toInt());
+}
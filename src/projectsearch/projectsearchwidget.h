@@ -0,0 +1,59 @@
+#ifndef PROJECTSEARCHWIDGET_H
+#define PROJECTSEARCHWIDGET_H
+
+#include <functional>
+#include <QWidget>
+#include <QHash>
+
+#include "projectsearcher.h"
+
+class ProjectSearchResultsModel;
+class QPushButton;
+class QCheckBox;
+class QLineEdit;
+class QListView;
+class QLabel;
+
+// "Find in project" tab of the bottom panel
+class ProjectSearchWidget: public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ProjectSearchWidget(QWidget *pParent = nullptr);
+
+    void setSearchScope(const QString &projectPath, const QStringList &fileExtensions);
+    // provider of unsaved content of opened documents (file name -> text)
+    void setOpenedBuffersProvider(std::function<QHash<QString, QString>()> provider);
+    void focusSearchLine();
+
+signals:
+    void openFileAtLine(const QString &fileName, int line);
+
+private:
+    QLineEdit *mpSearchLine;
+    QCheckBox *mpCaseSensitiveBox;
+    QCheckBox *mpWholeWordsBox;
+    QCheckBox *mpRegexBox;
+    QPushButton *mpSearchBtn;
+    QPushButton *mpStopBtn;
+    QLabel *mpStatusLbl;
+    QListView *mpResultsView;
+
+    ProjectSearchResultsModel *mpResultsModel;
+    ProjectSearcher *mpSearcher;
+    std::function<QHash<QString, QString>()> mOpenedBuffersProvider;
+
+    QString mProjectPath;
+    QStringList mNameFilters;
+    int mCurrentSearchId;
+
+private slots:
+    void onSearch();
+    void onStop();
+    void onHitsFound(int searchId, QVector<ProjectSearchHit> hits);
+    void onSearchFinished(int searchId, int filesSearched);
+    void onResultActivated(const QModelIndex &index);
+};
+
+#endif // PROJECTSEARCHWIDGET_H
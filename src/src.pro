@@ -51,6 +51,10 @@ include($$PWD/settingsconfigurator/settingsconfigurator.pri)
 include($$PWD/savefilesdialog/savefilesdialog.pri)
 include($$PWD/classgeneration/classgeneration.pri)
 include($$PWD/newprojectwizard/newprojectwizard.pri)
+include($$PWD/findreplace/findreplace.pri)
+include($$PWD/projectsearch/projectsearch.pri)
+include($$PWD/historysearch/historysearch.pri)
+include($$PWD/projectindex/projectindex.pri)
 
 RESOURCES += \
     globalresources.qrc
@@ -16,6 +16,7 @@ QMap<UserMessages, QString> userMessages =
     std::pair<UserMessages, const QString>(UserMessages::SelectDirectoryTitle, "Select project directory"),
     std::pair<UserMessages, const QString>(UserMessages::NewFileWizardMsg, "Please specify file name, file extension and project directory."),
     std::pair<UserMessages, const QString>(UserMessages::DocumentSavedMsg, "Changes to document have been saved"),
+    std::pair<UserMessages, const QString>(UserMessages::DocumentLoadingMsg, "Loading document: "),
     std::pair<UserMessages, const QString>(UserMessages::FileOpeningForSavingErrorMsg, "Unable to open file to save document/s"),
     std::pair<UserMessages, const QString>(UserMessages::FileOpeningErrorMsg, "Unable to open specified file."),
     std::pair<UserMessages, const QString>(UserMessages::DocumentAlreadyOpenedTitle, "Document already opened"),
@@ -53,4 +54,8 @@ QMap<UserMessages, QString> userMessages =
     std::pair<UserMessages, const QString>(UserMessages::InvalidProjectNameMsg, "Please enter valid project name."),
     std::pair<UserMessages, const QString>(UserMessages::ProjectDoesNotExistTitle, "Project does not exist"),
     std::pair<UserMessages, const QString>(UserMessages::ProjectDoesNotExistMsg, "Project does not exist in specified directory."),
+    std::pair<UserMessages, const QString>(UserMessages::FileChangedExternallyTitle, "File changed on disk"),
+    std::pair<UserMessages, const QString>(UserMessages::FileChangedExternallyMsg, "Files were changed outside of the IDE. Reload them and discard your changes?\n"),
+    std::pair<UserMessages, const QString>(UserMessages::UnsavedChangesRecoveredTitle, "Unsaved changes recovered"),
+    std::pair<UserMessages, const QString>(UserMessages::UnsavedChangesRecoveredMsg, "IDE was not closed properly last time. Restore unsaved changes of these files?\n"),
 };
@@ -20,6 +20,7 @@ enum class UserMessages
     SelectDirectoryTitle,
     NewFileWizardMsg,
     DocumentSavedMsg,
+    DocumentLoadingMsg,
     FileOpeningForSavingErrorMsg,
     FileOpeningErrorMsg,
     DocumentAlreadyOpenedTitle,
@@ -57,6 +58,10 @@ enum class UserMessages
     InvalidProjectNameMsg,
     ProjectDoesNotExistTitle,
     ProjectDoesNotExistMsg,
+    FileChangedExternallyTitle,
+    FileChangedExternallyMsg,
+    UnsavedChangesRecoveredTitle,
+    UnsavedChangesRecoveredMsg,
 };
 
 extern QMap<UserMessages, QString> userMessages;
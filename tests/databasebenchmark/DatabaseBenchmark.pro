@@ -0,0 +1,11 @@
+QT += core sql
+QT -= gui
+CONFIG += console c++14
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+SOURCES +=  \
+    benchmark.cpp
+
+include($$PWD/../../src/databaseaccessor/databaseaccessor.pri)
@@ -0,0 +1,348 @@
+// load test of comments & chat storage: every scenario is run against a new temporary
+// database of each scale & ops/sec with latency percentiles are printed,
+// usage: DatabaseBenchmark [--scales 1000,10000,100000,1000000,10000000] [--readers 2]
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QDateTime>
+#include <QThread>
+#include <QVector>
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <random>
+#include <memory>
+#include <deque>
+
+#include "sqliteaccess.h"
+
+namespace
+{
+
+const int COMMENTS_PER_FILE = 100;
+const int COMMENTS_BATCH_SIZE = 1000;
+const int USERS_COUNT = 10;
+const int READ_OPS_COUNT = 1000;
+const int MESSAGES_PAGE_SIZE = 50;
+// messages are queued to writer by chunks, so 10M of them are not kept in memory at once
+const int QUEUED_MESSAGES_LIMIT = 4 * DB_WRITES_BATCH_SIZE;
+const int CONCURRENT_WRITES_COUNT = 20000;
+const char *timeFormat = "yyyy-MM-dd hh:mm:ss";
+
+QTextStream& out()
+{
+    static QTextStream stdOut(stdout);
+    return stdOut;
+}
+
+// latencies are kept in microseconds
+class Measurement
+{
+public:
+    void addLatency(qint64 nsecs)
+    {
+        mLatencies.push_back(nsecs / 1000.0);
+    }
+
+    void report(const QString &scenario, qint64 rowsCount, qint64 opsCount, qint64 elapsedMsecs)
+    {
+        std::sort(mLatencies.begin(), mLatencies.end());
+        const double seconds = qMax<qint64>(elapsedMsecs, 1) / 1000.0;
+        out() << qSetFieldWidth(34) << left << scenario
+              << qSetFieldWidth(10) << right << rowsCount
+              << qSetFieldWidth(14) << QString::number(opsCount / seconds, 'f', 0)
+              << qSetFieldWidth(12) << QString::number(percentile(0.5), 'f', 1)
+              << QString::number(percentile(0.95), 'f', 1)
+              << QString::number(percentile(0.99), 'f', 1)
+              << QString::number(mLatencies.empty() ? 0.0 : mLatencies.back(), 'f', 1)
+              << qSetFieldWidth(0) << endl;
+    }
+
+private:
+    double percentile(double rank) const
+    {
+        if (mLatencies.empty())
+        {
+            return 0.0;
+        }
+        return mLatencies[static_cast<size_t>(rank * (mLatencies.size() - 1))];
+    }
+
+    std::vector<double> mLatencies;
+};
+
+QString fileName(int fileIndex)
+{
+    return QString("/benchmark/project/dir%1/file%2.cpp").arg(fileIndex % 100).arg(fileIndex);
+}
+
+QString userName(int userIndex)
+{
+    return QString("user%1").arg(userIndex);
+}
+
+QString messageTime(const QDateTime &baseTime, qint64 messageIndex)
+{
+    return baseTime.addSecs(messageIndex).toString(timeFormat);
+}
+
+// messages are written by writer thread & their latency is time until their write is committed
+void writeMessages(qint64 firstIndex, qint64 count, const QDateTime &baseTime, Measurement &measurement)
+{
+    MessageDb messageDb;
+    std::deque<std::pair<std::future<bool>, QElapsedTimer>> queuedWrites;
+    auto finishOldestWrite = [&queuedWrites, &measurement]()
+    {
+        queuedWrites.front().first.wait();
+        measurement.addLatency(queuedWrites.front().second.nsecsElapsed());
+        queuedWrites.pop_front();
+    };
+
+    for (qint64 i = firstIndex; i < firstIndex + count; ++i)
+    {
+        if (queuedWrites.size() >= static_cast<size_t>(QUEUED_MESSAGES_LIMIT))
+        {
+            finishOldestWrite();
+        }
+        QElapsedTimer timer;
+        timer.start();
+        const Message message(QString("message %1 about build of module %2").arg(i).arg(i % 97),
+                              userName(static_cast<int>(i % USERS_COUNT)), messageTime(baseTime, i));
+        queuedWrites.emplace_back(messageDb.addMessageToDbAsync(message), timer);
+    }
+    while (!queuedWrites.empty())
+    {
+        finishOldestWrite();
+    }
+}
+
+// reads pages of chat history on its own read-only connection until it's stopped,
+// older pages don't wait for queued writes, so latency of reads concurrent with commits is measured
+class HistoryReader: public QThread
+{
+public:
+    HistoryReader(const QDateTime &baseTime, qint64 messagesCount, std::atomic<bool> &stopRequested):
+        mBaseTime(baseTime), mMessagesCount(messagesCount), mStopRequested(stopRequested)
+    {
+    }
+
+    Measurement mMeasurement;
+    qint64 mOpsCount = 0;
+
+protected:
+    void run() override
+    {
+        MessageDb messageDb(ConnectionMode::ReadOnly);
+        std::mt19937_64 random(reinterpret_cast<quintptr>(this));
+        std::uniform_int_distribution<qint64> messageIndex(0, mMessagesCount);
+        while (!mStopRequested)
+        {
+            QElapsedTimer timer;
+            timer.start();
+            messageDb.getMessagesPageFromDb(messageTime(mBaseTime, messageIndex(random)), 0, MESSAGES_PAGE_SIZE);
+            mMeasurement.addLatency(timer.nsecsElapsed());
+            ++mOpsCount;
+        }
+    }
+
+private:
+    QDateTime mBaseTime;
+    qint64 mMessagesCount;
+    std::atomic<bool> &mStopRequested;
+};
+
+void runScale(const QString &databasePath, qint64 rowsCount, int readersCount)
+{
+    ConnectionGetter::getDefaultConnection(databasePath);
+    CreateDB database;
+    database.addTableFile();
+    database.addTableUser();
+    database.addTableComment();
+    database.addTableMessage();
+    database.migrateSchema();
+
+    const int filesCount = static_cast<int>(qMax<qint64>(1, rowsCount / COMMENTS_PER_FILE));
+    const QDateTime baseTime = QDateTime::fromString("2020-01-01 00:00:00", timeFormat);
+    std::mt19937_64 random(rowsCount);
+
+    // users & files
+    {
+        Measurement measurement;
+        QElapsedTimer total;
+        total.start();
+        UserDb userDb;
+        FileDb fileDb;
+        for (int i = 0; i < USERS_COUNT; ++i)
+        {
+            QElapsedTimer timer;
+            timer.start();
+            userDb.addUserToDb(User(userName(i)));
+            measurement.addLatency(timer.nsecsElapsed());
+        }
+        for (int i = 0; i < filesCount; ++i)
+        {
+            QElapsedTimer timer;
+            timer.start();
+            fileDb.addFileToDb(File(fileName(i)));
+            measurement.addLatency(timer.nsecsElapsed());
+        }
+        measurement.report("insert user/file (autocommit)", rowsCount, USERS_COUNT + filesCount, total.elapsed());
+    }
+
+    // comments are written by transactions of batch size, latency is per batch
+    {
+        Measurement measurement;
+        QElapsedTimer total;
+        total.start();
+        CommentDb commentDb;
+        QVector<Comment> batch;
+        batch.reserve(COMMENTS_BATCH_SIZE);
+        for (qint64 i = 0; i < rowsCount; ++i)
+        {
+            batch.push_back(Comment(static_cast<int>(i % COMMENTS_PER_FILE) + 1,
+                                    QString("comment %1 on unused variable").arg(i),
+                                    userName(static_cast<int>(i % USERS_COUNT)),
+                                    fileName(static_cast<int>(i / COMMENTS_PER_FILE))));
+            if (batch.size() == COMMENTS_BATCH_SIZE || i == rowsCount - 1)
+            {
+                QElapsedTimer timer;
+                timer.start();
+                commentDb.writeCommentsChanges(batch, {});
+                measurement.addLatency(timer.nsecsElapsed());
+                batch.clear();
+            }
+        }
+        measurement.report("bulk insert comments (per batch)", rowsCount, rowsCount, total.elapsed());
+    }
+
+    // messages through writer thread
+    {
+        Measurement measurement;
+        QElapsedTimer total;
+        total.start();
+        writeMessages(0, rowsCount, baseTime, measurement);
+        measurement.report("bulk insert messages (writer)", rowsCount, rowsCount, total.elapsed());
+    }
+
+    // comments of file are reloaded as when it's opened
+    {
+        Measurement measurement;
+        QElapsedTimer total;
+        total.start();
+        CommentDb commentDb;
+        std::uniform_int_distribution<int> fileIndex(0, filesCount - 1);
+        for (int i = 0; i < READ_OPS_COUNT; ++i)
+        {
+            QElapsedTimer timer;
+            timer.start();
+            commentDb.getAllCommentsFromFile(fileName(fileIndex(random)));
+            measurement.addLatency(timer.nsecsElapsed());
+        }
+        measurement.report("reload comments of file", rowsCount, READ_OPS_COUNT, total.elapsed());
+    }
+
+    // history page before random message & the newest messages since time
+    {
+        Measurement pageMeasurement;
+        Measurement rangeMeasurement;
+        MessageDb messageDb;
+        std::uniform_int_distribution<qint64> messageIndex(0, rowsCount);
+        QElapsedTimer total;
+        total.start();
+        for (int i = 0; i < READ_OPS_COUNT; ++i)
+        {
+            QElapsedTimer timer;
+            timer.start();
+            messageDb.getMessagesPageFromDb(messageTime(baseTime, messageIndex(random)), 0, MESSAGES_PAGE_SIZE);
+            pageMeasurement.addLatency(timer.nsecsElapsed());
+        }
+        pageMeasurement.report("message page (keyset)", rowsCount, READ_OPS_COUNT, total.elapsed());
+
+        total.restart();
+        for (int i = 0; i < READ_OPS_COUNT; ++i)
+        {
+            QElapsedTimer timer;
+            timer.start();
+            messageDb.getMessageFromDb(messageTime(baseTime, rowsCount - MESSAGES_PAGE_SIZE));
+            rangeMeasurement.addLatency(timer.nsecsElapsed());
+        }
+        rangeMeasurement.report("messages since time (range)", rowsCount, READ_OPS_COUNT, total.elapsed());
+    }
+
+    // readers load history while messages are written
+    {
+        std::atomic<bool> stopRequested(false);
+        std::vector<std::unique_ptr<HistoryReader>> readers;
+        for (int i = 0; i < readersCount; ++i)
+        {
+            readers.emplace_back(new HistoryReader(baseTime, rowsCount, stopRequested));
+            readers.back()->start();
+        }
+
+        Measurement writeMeasurement;
+        QElapsedTimer total;
+        total.start();
+        writeMessages(rowsCount, CONCURRENT_WRITES_COUNT, baseTime, writeMeasurement);
+        const qint64 elapsed = total.elapsed();
+        stopRequested = true;
+
+        writeMeasurement.report("concurrent: messages (writer)", rowsCount, CONCURRENT_WRITES_COUNT, elapsed);
+        for (auto &pReader : readers)
+        {
+            pReader->wait();
+            pReader->mMeasurement.report("concurrent: message page (reader)", rowsCount,
+                                         pReader->mOpsCount, elapsed);
+        }
+    }
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Load test of comments & chat storage");
+    parser.addHelpOption();
+    QCommandLineOption scalesOption("scales", "Comma separated rows counts of tested databases.",
+                                    "rows", "1000,10000,100000,1000000");
+    QCommandLineOption readersOption("readers", "Count of threads which read history during writes.",
+                                     "count", "2");
+    parser.addOption(scalesOption);
+    parser.addOption(readersOption);
+    parser.process(app);
+
+    QTemporaryDir tempDir;
+    if (!tempDir.isValid())
+    {
+        out() << "temporary directory can't be created" << endl;
+        return 1;
+    }
+
+    out() << qSetFieldWidth(34) << left << "scenario"
+          << qSetFieldWidth(10) << right << "rows"
+          << qSetFieldWidth(14) << "ops/sec"
+          << qSetFieldWidth(12) << "p50 us" << "p95 us" << "p99 us" << "max us"
+          << qSetFieldWidth(0) << endl;
+
+    for (const auto &scale : parser.value(scalesOption).split(',', QString::SkipEmptyParts))
+    {
+        bool isNumber = false;
+        const qint64 rowsCount = scale.toLongLong(&isNumber);
+        if (!isNumber || rowsCount <= 0)
+        {
+            out() << "wrong scale: " << scale << endl;
+            continue;
+        }
+        runScale(tempDir.filePath(QString("benchmark%1.db").arg(rowsCount)), rowsCount,
+                 parser.value(readersOption).toInt());
+        out() << endl;
+    }
+
+    // connection to the last database is closed before it's removed with temporary directory
+    ConnectionGetter::closeThreadConnections();
+    return 0;
+}
@@ -0,0 +1,10 @@
+QT += testlib core sql
+QT -= gui
+CONFIG += qt warn_on depend_includepath testcase c++14
+
+TEMPLATE = app
+
+SOURCES +=  \
+    tst.cpp
+
+include($$PWD/../../src/databaseaccessor/databaseaccessor.pri)
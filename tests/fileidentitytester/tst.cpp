@@ -0,0 +1,164 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QSaveFile>
+#include <memory>
+#include "sqliteaccess.h"
+#include "fileidentity.h"
+
+class FileIdentityTests: public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+    void cleanupTestCase();
+
+    void renamedFileKeepsId();
+    void savedAndRenamedFileKeepsId();
+    void movedFileIsDetectedBeforeOpening();
+    void newFileWithKeyOfDeletedOneIsNotMatched();
+    void copyOfDeletedFileIsNotMatched();
+    void emptyFileIsNotMatched();
+
+private:
+    QString filePath(const QString &name) const;
+    static void writeFile(const QString &fileName, const QByteArray &content);
+    static int addFile(const QString &fileName);
+
+    // every test gets its own project database
+    std::unique_ptr<QTemporaryDir> mpDir;
+};
+
+QString FileIdentityTests::filePath(const QString &name) const
+{
+    return mpDir->filePath(name);
+}
+
+void FileIdentityTests::writeFile(const QString &fileName, const QByteArray &content)
+{
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(content), static_cast<qint64>(content.size()));
+}
+
+int FileIdentityTests::addFile(const QString &fileName)
+{
+    FileDb().addFileToDb(File(fileName));
+    return FileDb().getFileIdFromDb(fileName);
+}
+
+void FileIdentityTests::init()
+{
+    mpDir.reset(new QTemporaryDir);
+    QVERIFY(mpDir->isValid());
+    ConnectionGetter::getDefaultConnection(filePath("storage.db"));
+    CreateDB database;
+    database.addTableFile();
+    database.addTableUser();
+    database.addTableComment();
+    database.addTableMessage();
+    database.migrateSchema();
+}
+
+void FileIdentityTests::cleanup()
+{
+    // queued updates are committed before database is removed
+    DbWriter::getDefaultWriter()->waitForDone();
+}
+
+void FileIdentityTests::cleanupTestCase()
+{
+    ConnectionGetter::closeThreadConnections();
+}
+
+void FileIdentityTests::renamedFileKeepsId()
+{
+    const QString oldName = filePath("old.cpp");
+    const QString newName = filePath("new.cpp");
+    writeFile(oldName, "int main() {}\n");
+    const int id = addFile(oldName);
+    QVERIFY(id);
+
+    QVERIFY(QFile::rename(oldName, newName));
+    QCOMPARE(FileDb().resolveFileIdFromDb(newName), id);
+
+    DbWriter::getDefaultWriter()->waitForDone();
+    QCOMPARE(FileDb().getFileIdFromDb(newName), id);
+    QCOMPARE(FileDb().getFileIdFromDb(oldName), 0);
+}
+
+void FileIdentityTests::savedAndRenamedFileKeepsId()
+{
+    const QString oldName = filePath("old.cpp");
+    const QString newName = filePath("new.cpp");
+    writeFile(oldName, "int main() {}\n");
+    const int id = addFile(oldName);
+    QVERIFY(id);
+
+    // file is replaced on save, so both its key & content are changed
+    QSaveFile savedFile(oldName);
+    QVERIFY(savedFile.open(QIODevice::WriteOnly));
+    savedFile.write("int main() { return 0; }\n");
+    QVERIFY(savedFile.commit());
+    FileDb().updateFileIdentityAsync(oldName);
+
+    // identity is updated on worker, file isn't matched by stale one
+    QVERIFY(QFile::rename(oldName, newName));
+    QTRY_COMPARE(FileDb().resolveFileIdFromDb(newName), id);
+}
+
+void FileIdentityTests::movedFileIsDetectedBeforeOpening()
+{
+    const QString oldName = filePath("old.cpp");
+    QVERIFY(QDir(mpDir->path()).mkdir("moved"));
+    const QString newName = filePath("moved/new.cpp");
+    writeFile(oldName, "int main() {}\n");
+    const int id = addFile(oldName);
+    QVERIFY(id);
+
+    // project file watcher reports file which appeared in directory
+    QVERIFY(QFile::rename(oldName, newName));
+    FileDb().detectMovedFilesAsync({newName});
+    QTRY_COMPARE(FileDb().getFileIdFromDb(newName), id);
+    QCOMPARE(FileDb().getFileIdFromDb(oldName), 0);
+}
+
+void FileIdentityTests::newFileWithKeyOfDeletedOneIsNotMatched()
+{
+    // key of deleted file is reused by file system for new one with another content
+    const QString newName = filePath("new.cpp");
+    writeFile(newName, "int main() { return 1; }\n");
+    File deletedFile(filePath("deleted.cpp"));
+    deletedFile.mKey = FileIdentity::getFileKey(newName);
+    deletedFile.mFingerprint = QString(40, '0');
+    FileDb().addFileToDb(deletedFile);
+    QVERIFY(FileDb().getFileIdFromDb(deletedFile.mName));
+
+    QCOMPARE(FileDb().resolveFileIdFromDb(newName), 0);
+}
+
+void FileIdentityTests::copyOfDeletedFileIsNotMatched()
+{
+    const QString oldName = filePath("old.cpp");
+    const QString copyName = filePath("copy.cpp");
+    writeFile(oldName, "int main() {}\n");
+    QVERIFY(addFile(oldName));
+
+    QVERIFY(QFile::copy(oldName, copyName));
+    QVERIFY(QFile::remove(oldName));
+    QCOMPARE(FileDb().resolveFileIdFromDb(copyName), 0);
+}
+
+void FileIdentityTests::emptyFileIsNotMatched()
+{
+    const QString oldName = filePath("old.cpp");
+    const QString newName = filePath("new.cpp");
+    writeFile(oldName, QByteArray());
+    QVERIFY(addFile(oldName));
+
+    QVERIFY(QFile::rename(oldName, newName));
+    QCOMPARE(FileDb().resolveFileIdFromDb(newName), 0);
+}
+
+QTEST_GUILESS_MAIN(FileIdentityTests)
+#include "tst.moc"
@@ -0,0 +1,16 @@
+QT += testlib core
+QT -= gui
+CONFIG += qt warn_on depend_includepath testcase c++14
+
+TEMPLATE = app
+
+SOURCES +=  \
+    tst.cpp
+
+SOURCES += \
+    $$PWD/../../src/editor/textdiff.cpp
+
+HEADERS += \
+    $$PWD/../../src/editor/textdiff.h
+
+INCLUDEPATH += $$PWD/../../src/editor
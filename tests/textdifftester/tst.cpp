@@ -0,0 +1,181 @@
+#include <QtTest>
+#include <random>
+#include "textdiff.h"
+
+class TextDiffTests: public QObject
+{
+    Q_OBJECT
+private slots:
+    void splitKeepsLineBreaks();
+    void equalTextsHaveNoHunks();
+    void crlfTextEqualsNormalizedOne();
+    void insertedLine();
+    void removedLine();
+    void replacedLine();
+    void separateChanges();
+    void tooDifferentTextsAreOneHunk();
+    void hunksTurnOldTextIntoNew();
+
+private:
+    static QStringList applyHunks(const QStringList &oldLines, const QStringList &newLines,
+                                  const QVector<LineHunk> &hunks);
+    static int changedLinesCount(const QVector<LineHunk> &hunks);
+};
+
+QStringList TextDiffTests::applyHunks(const QStringList &oldLines, const QStringList &newLines,
+                                      const QVector<LineHunk> &hunks)
+{
+    // hunks are applied from the end, so positions of earlier ones stay valid
+    QStringList rLines = oldLines;
+    for (int i = hunks.size() - 1; i >= 0; --i)
+    {
+        const LineHunk &hunk = hunks[i];
+        for (int j = 0; j < hunk.mOldCount; ++j)
+        {
+            rLines.removeAt(hunk.mOldStart);
+        }
+        for (int j = 0; j < hunk.mNewCount; ++j)
+        {
+            rLines.insert(hunk.mOldStart + j, newLines[hunk.mNewStart + j]);
+        }
+    }
+    return rLines;
+}
+
+int TextDiffTests::changedLinesCount(const QVector<LineHunk> &hunks)
+{
+    int rCount = 0;
+    for (const auto &hunk : hunks)
+    {
+        rCount += hunk.mOldCount + hunk.mNewCount;
+    }
+    return rCount;
+}
+
+void TextDiffTests::splitKeepsLineBreaks()
+{
+    QCOMPARE(splitLines("a\nb\n"), QStringList({"a\n", "b\n"}));
+    QCOMPARE(splitLines("a\n\nb"), QStringList({"a\n", "\n", "b"}));
+    QCOMPARE(splitLines(""), QStringList());
+}
+
+void TextDiffTests::equalTextsHaveNoHunks()
+{
+    const QStringList lines = splitLines("a\nb\nc\n");
+    QVERIFY(diffLines(lines, lines).isEmpty());
+}
+
+void TextDiffTests::crlfTextEqualsNormalizedOne()
+{
+    QCOMPARE(normalizeLineBreaks("a\r\nb\rc\n\r\n"), QString("a\nb\nc\n\n"));
+    const QStringList docLines = splitLines("a\nb\nc\n");
+    QVERIFY(diffLines(docLines, splitLines(normalizeLineBreaks("a\r\nb\r\nc\r\n"))).isEmpty());
+
+    const QVector<LineHunk> hunks = diffLines(docLines, splitLines(normalizeLineBreaks("a\r\nx\r\nc\r\n")));
+    QCOMPARE(hunks.size(), 1);
+    QCOMPARE(hunks[0].mOldStart, 1);
+    QCOMPARE(hunks[0].mOldCount, 1);
+    QCOMPARE(hunks[0].mNewStart, 1);
+    QCOMPARE(hunks[0].mNewCount, 1);
+}
+
+void TextDiffTests::insertedLine()
+{
+    const QVector<LineHunk> hunks = diffLines(splitLines("a\nb\nc\n"), splitLines("a\nb\nx\nc\n"));
+    QCOMPARE(hunks.size(), 1);
+    QCOMPARE(hunks[0].mOldStart, 2);
+    QCOMPARE(hunks[0].mOldCount, 0);
+    QCOMPARE(hunks[0].mNewStart, 2);
+    QCOMPARE(hunks[0].mNewCount, 1);
+}
+
+void TextDiffTests::removedLine()
+{
+    const QVector<LineHunk> hunks = diffLines(splitLines("a\nb\nc\n"), splitLines("a\nc\n"));
+    QCOMPARE(hunks.size(), 1);
+    QCOMPARE(hunks[0].mOldStart, 1);
+    QCOMPARE(hunks[0].mOldCount, 1);
+    QCOMPARE(hunks[0].mNewCount, 0);
+}
+
+void TextDiffTests::replacedLine()
+{
+    const QVector<LineHunk> hunks = diffLines(splitLines("a\nb\nc\n"), splitLines("a\nx\nc\n"));
+    QCOMPARE(hunks.size(), 1);
+    QCOMPARE(hunks[0].mOldStart, 1);
+    QCOMPARE(hunks[0].mOldCount, 1);
+    QCOMPARE(hunks[0].mNewStart, 1);
+    QCOMPARE(hunks[0].mNewCount, 1);
+}
+
+void TextDiffTests::separateChanges()
+{
+    const QStringList oldLines = splitLines("a\nb\nc\nd\ne\n");
+    const QStringList newLines = splitLines("x\nb\nc\nd\ny\ne\n");
+    const QVector<LineHunk> hunks = diffLines(oldLines, newLines);
+    QCOMPARE(hunks.size(), 2);
+    QCOMPARE(changedLinesCount(hunks), 3);
+    QCOMPARE(applyHunks(oldLines, newLines, hunks), newLines);
+}
+
+void TextDiffTests::tooDifferentTextsAreOneHunk()
+{
+    QStringList oldLines;
+    QStringList newLines;
+    oldLines << "same\n";
+    newLines << "same\n";
+    for (int i = 0; i < MAX_DIFF_EDIT_DISTANCE; ++i)
+    {
+        oldLines << QString("old %1\n").arg(i);
+        newLines << QString("new %1\n").arg(i);
+    }
+    const QVector<LineHunk> hunks = diffLines(oldLines, newLines);
+    QCOMPARE(hunks.size(), 1);
+    QCOMPARE(hunks[0].mOldStart, 1);
+    QCOMPARE(hunks[0].mOldCount, MAX_DIFF_EDIT_DISTANCE);
+    QCOMPARE(hunks[0].mNewCount, MAX_DIFF_EDIT_DISTANCE);
+    QCOMPARE(applyHunks(oldLines, newLines, hunks), newLines);
+}
+
+void TextDiffTests::hunksTurnOldTextIntoNew()
+{
+    // random edits of text, diff is never longer than the edits which were made
+    std::mt19937 random(42);
+    for (int iteration = 0; iteration < 200; ++iteration)
+    {
+        QStringList oldLines;
+        const int linesCount = static_cast<int>(random() % 50);
+        for (int i = 0; i < linesCount; ++i)
+        {
+            oldLines << QString("line %1\n").arg(random() % 10);
+        }
+
+        QStringList newLines = oldLines;
+        int editsCount = 0;
+        const int edits = static_cast<int>(random() % 6);
+        for (int i = 0; i < edits; ++i)
+        {
+            const int position = static_cast<int>(random() % (newLines.size() + 1));
+            if (random() % 2 && position < newLines.size())
+            {
+                newLines.removeAt(position);
+            }
+            else
+            {
+                newLines.insert(position, QString("inserted %1\n").arg(i));
+            }
+            ++editsCount;
+        }
+
+        const QVector<LineHunk> hunks = diffLines(oldLines, newLines);
+        QCOMPARE(applyHunks(oldLines, newLines, hunks), newLines);
+        QVERIFY(changedLinesCount(hunks) <= editsCount);
+        for (int i = 1; i < hunks.size(); ++i)
+        {
+            QVERIFY(hunks[i].mOldStart >= hunks[i - 1].mOldStart + hunks[i - 1].mOldCount);
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(TextDiffTests)
+#include "tst.moc"